@@ -0,0 +1,993 @@
+/************************************BEGIN*****************************************
+*                       COPYRIGHT %G% %U% BY GHWORKS, LLC 
+*                             ALL RIGHTS RESERVED
+*                         SPDX-License-Identifier: MIT
+* ********************************************************************************
+* Name:        bench
+* Type:        C Source
+* File:        %M%
+* Version:     %I%
+* Description: Kernel Microbenchmark and Latency Suite
+*
+* Interface (public) Routines:
+*
+*	main
+*
+* Private Functions:
+*
+*	bench_cmp
+*	bench_consumer
+*	bench_evpong
+*	bench_evwake
+*	bench_idle
+*	bench_main
+*	bench_ns
+*	bench_producer
+*	bench_qpingpong
+*	bench_qpong
+*	bench_qthroughput
+*	bench_rate
+*	bench_report
+*	bench_smcontended
+*	bench_smpong
+*	bench_smuncontended
+*	bench_task
+*	bench_tasklife
+*	bench_timer
+*
+* Modification History:
+* ----------------------------------------------------------- 
+* Date		Initials		Change Description
+* -----------------------------------------------------------
+* 10/14/26	GVH				Created
+*
+**************************************END***************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "gxkHost.h"
+#include "gxkernel.h"
+#include "gxkCfg.h"
+
+/********************************
+		LOCAL DECLARATIONS
+********************************/
+
+/*
+ * a program of its own, linked with the kernel in place of the
+ * application.  one controller task runs the benchmarks in turn
+ * against responder tasks of higher priority, timing each operation
+ * with the host counter, and prints one CSV row per metric:
+ *
+ *	bench,metric,value,unit
+ *
+ * latencies are given as min, p50, p99, p99.9 and max in ns, so runs
+ * of two releases can be diffed or loaded into a spreadsheet
+ */
+
+ULONG gxkInit(void);
+
+#define BENCH_SAMPLES		10000				/* timed operations per latency benchmark */
+#define BENCH_PRODUCERS		4					/* tasks sending in the throughput benchmark */
+#define BENCH_MESSAGES		50000				/* messages each producer sends */
+#define BENCH_TICKS			500					/* timer expiries timed for jitter */
+#define BENCH_STACK			4000
+
+#define CTL_PRIO			50					/* controller */
+#define PONG_PRIO			100					/* responders, preempt the controller */
+#define PROD_PRIO			40					/* producers, below the controller */
+
+#define EV_PING				0x00000001
+#define EV_PONG				0x00000002
+#define EV_TICK				0x00000004
+
+/********************************
+		GLOBALS
+********************************/
+
+LONGLONG BenchFreq;
+volatile LONGLONG BenchStamp;				/* counter when the timed call was made */
+LONGLONG BenchSample[BENCH_SAMPLES];
+volatile ULONG BenchCount;
+
+ULONG BenchCtl;								/* controller task id */
+ULONG BenchQ[2];
+ULONG BenchSm[3];
+volatile LONG BenchLeft;					/* messages the consumer has still to take */
+volatile ULONG BenchRuns;					/* bench_idle bodies entered */
+
+GXKEVENT BenchDone;
+
+/******************************************************************************
+*						  
+* Name:				bench_ns
+*
+* Type:				Function
+*
+* Description:		host counts to ns
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static LONGLONG bench_ns(LONGLONG counts)
+
+{
+	return ((LONGLONG)((double)counts * 1e9 / (double)BenchFreq));
+}
+
+/******************************************************************************
+*						  
+* Name:				bench_cmp
+*
+* Type:				Function
+*
+* Description:		qsort order of two samples
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static int bench_cmp(const void *a, const void *b)
+
+{
+	LONGLONG x;
+	LONGLONG y;
+
+	x = *(const LONGLONG *)a;
+	y = *(const LONGLONG *)b;
+
+	return ((x < y) ? -1 : ((x > y) ? 1 : 0));
+}
+
+/******************************************************************************
+*						  
+* Name:				bench_report
+*
+* Type:				Function
+*
+* Description:		print the spread of the samples taken
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void bench_report(const char *bench)
+
+{
+	ULONG n;
+
+	n = BenchCount;
+
+	printf ("%s,samples,%lu,count\n", bench, (unsigned long)n);
+
+	if (n != 0)
+	{
+		qsort (BenchSample, n, sizeof (LONGLONG), bench_cmp);
+
+		printf ("%s,min,%lld,ns\n", bench, bench_ns (BenchSample[0]));
+		printf ("%s,p50,%lld,ns\n", bench, bench_ns (BenchSample[(n * 50) / 100]));
+		printf ("%s,p99,%lld,ns\n", bench, bench_ns (BenchSample[(n * 99) / 100]));
+		printf ("%s,p99.9,%lld,ns\n", bench, bench_ns (BenchSample[(n * 999) / 1000]));
+		printf ("%s,max,%lld,ns\n", bench, bench_ns (BenchSample[n - 1]));
+	}
+
+	fflush (stdout);
+}
+
+/******************************************************************************
+*						  
+* Name:				bench_rate
+*
+* Type:				Function
+*
+* Description:		print operations per second over an interval
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void bench_rate(const char *bench, ULONG ops, LONGLONG counts)
+
+{
+	printf ("%s,ops,%lu,count\n", bench, (unsigned long)ops);
+	printf ("%s,rate,%.0f,ops/s\n", bench, (counts > 0) ? ((double)ops * (double)BenchFreq / (double)counts) : 0.0);
+
+	fflush (stdout);
+}
+
+/******************************************************************************
+*						  
+* Name:				bench_task
+*
+* Type:				Function
+*
+* Description:		create and start a benchmark task
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static ULONG bench_task(char name[4], ULONG prio, ULONG mode, void (*entry)(ULONG *), ULONG arg)
+
+{
+	ULONG tid;
+	ULONG targs[4];
+
+	targs[0] = arg;
+	targs[1] = targs[2] = targs[3] = 0;
+
+	if ((t_create (name, prio, BENCH_STACK, BENCH_STACK, 0, &tid) != 0) ||
+		(t_start (tid, mode, (void (*)())entry, targs) != 0))
+	{
+		printf ("%.4s,error,1,count\n", name);
+		tid = MAX_TASK;
+	}
+
+	return (tid);
+}
+
+/******************************************************************************
+*						  
+* Name:				bench_idle
+*
+* Type:				Function
+*
+* Description:		body of the tasks timed in bench_tasklife
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void bench_idle(ULONG *targs)
+
+{
+	/*
+	 * started above the controller, so it runs and blocks here before
+	 * the controller gets back to delete it
+	 */
+
+	(void)targs;
+
+	BenchRuns++;
+
+	for (;;)
+	{
+		tm_wkafter (100);
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				bench_qpong
+*
+* Type:				Function
+*
+* Description:		receive a ping, time it, and answer
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void bench_qpong(ULONG *targs)
+
+{
+	ULONG msg[4];
+
+	(void)targs;
+
+	for (;;)
+	{
+		if (q_receive (BenchQ[0], Q_WAIT, 0, msg) == 0)
+		{
+			BenchSample[BenchCount++] = gxk_h_clock () - BenchStamp;
+
+			q_send (BenchQ[1], msg);
+		}
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				bench_qpingpong
+*
+* Type:				Function
+*
+* Description:		q_send to q_receive latency of a blocked receiver
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void bench_qpingpong(void)
+
+{
+	ULONG inx;
+	ULONG tid;
+	ULONG msg[4];
+
+	/*
+	 * the responder waits in q_receive on one queue and answers on
+	 * the other, so each ping is timed from the same state whatever
+	 * the number of cores
+	 */
+
+	q_create ("BQ0", 4, Q_FIFO, &BenchQ[0]);
+	q_create ("BQ1", 4, Q_FIFO, &BenchQ[1]);
+
+	tid = bench_task ("BQPG", PONG_PRIO, T_PREEMPT, bench_qpong, 0);
+
+	msg[0] = msg[1] = msg[2] = msg[3] = 0;
+
+	for (BenchCount = 0, inx = 0; inx < BENCH_SAMPLES; inx++)
+	{
+		BenchStamp = gxk_h_clock ();
+
+		q_send (BenchQ[0], msg);
+		q_receive (BenchQ[1], Q_WAIT, 0, msg);
+	}
+
+	bench_report ("q_pingpong");
+
+	t_delete (tid);
+	q_delete (BenchQ[0]);
+	q_delete (BenchQ[1]);
+}
+
+/******************************************************************************
+*						  
+* Name:				bench_consumer
+*
+* Type:				Function
+*
+* Description:		take the throughput benchmark's messages
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void bench_consumer(ULONG *targs)
+
+{
+	ULONG msg[4][4];
+	ULONG cnt;
+
+	(void)targs;
+
+	for (;;)
+	{
+		if (q_receive_n (BenchQ[0], Q_WAIT, 0, msg, 4, &cnt) == 0)
+		{
+			if (InterlockedExchangeAdd (&BenchLeft, -(LONG)cnt) == (LONG)cnt)
+			{
+				sm_v (BenchSm[0]);
+			}
+		}
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				bench_producer
+*
+* Type:				Function
+*
+* Description:		send a run of messages, waiting out a full queue
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void bench_producer(ULONG *targs)
+
+{
+	ULONG inx;
+	ULONG msg[4];
+
+	msg[0] = targs[0];
+	msg[2] = msg[3] = 0;
+
+	for (inx = 0; inx < BENCH_MESSAGES; inx++)
+	{
+		msg[1] = inx;
+
+		while (q_send (BenchQ[0], msg) == ERR_QFULL)
+		{
+			tm_wkafter (0);
+		}
+	}
+
+	for (;;)
+	{
+		tm_wkafter (100);
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				bench_qthroughput
+*
+* Type:				Function
+*
+* Description:		messages per second from several producers to one consumer
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void bench_qthroughput(void)
+
+{
+	ULONG inx;
+	ULONG cons;
+	ULONG prod[BENCH_PRODUCERS];
+	LONGLONG start;
+	LONGLONG counts;
+
+	/*
+	 * the producers are below the controller and time slice among
+	 * themselves, so they all run from when it blocks until the
+	 * consumer has taken the last message
+	 */
+
+	q_create ("BQT", 256, Q_FIFO, &BenchQ[0]);
+	sm_create ("BSD", 0, SM_FIFO, &BenchSm[0]);
+
+	BenchLeft = BENCH_PRODUCERS * BENCH_MESSAGES;
+
+	cons = bench_task ("BQCN", PONG_PRIO, T_PREEMPT, bench_consumer, 0);
+
+	for (inx = 0; inx < BENCH_PRODUCERS; inx++)
+	{
+		prod[inx] = bench_task ("BQPR", PROD_PRIO, T_PREEMPT | T_TSLICE, bench_producer, inx);
+	}
+
+	start = gxk_h_clock ();
+
+	sm_p (BenchSm[0], SM_WAIT, 0);
+
+	counts = gxk_h_clock () - start;
+
+	bench_rate ("q_throughput", BENCH_PRODUCERS * BENCH_MESSAGES, counts);
+
+	for (inx = 0; inx < BENCH_PRODUCERS; inx++)
+	{
+		t_delete (prod[inx]);
+	}
+
+	t_delete (cons);
+	q_delete (BenchQ[0]);
+	sm_delete (BenchSm[0]);
+}
+
+/******************************************************************************
+*						  
+* Name:				bench_smuncontended
+*
+* Type:				Function
+*
+* Description:		cost of an sm_p and sm_v pair that never blocks
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void bench_smuncontended(void)
+
+{
+	ULONG inx;
+	LONGLONG start;
+
+	sm_create ("BSU", 1, SM_FIFO, &BenchSm[0]);
+
+	for (BenchCount = 0, inx = 0; inx < BENCH_SAMPLES; inx++)
+	{
+		start = gxk_h_clock ();
+
+		sm_p (BenchSm[0], SM_NOWAIT, 0);
+		sm_v (BenchSm[0]);
+
+		BenchSample[BenchCount++] = gxk_h_clock () - start;
+	}
+
+	bench_report ("sm_uncontended");
+
+	sm_delete (BenchSm[0]);
+}
+
+/******************************************************************************
+*						  
+* Name:				bench_smpong
+*
+* Type:				Function
+*
+* Description:		take a handed over semaphore, time it, and answer
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void bench_smpong(ULONG *targs)
+
+{
+	(void)targs;
+
+	for (;;)
+	{
+		if (sm_p (BenchSm[1], SM_WAIT, 0) == 0)
+		{
+			BenchSample[BenchCount++] = gxk_h_clock () - BenchStamp;
+
+			sm_v (BenchSm[2]);
+		}
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				bench_smcontended
+*
+* Type:				Function
+*
+* Description:		sm_v to sm_p latency of a blocked taker
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void bench_smcontended(void)
+
+{
+	ULONG inx;
+	ULONG tid;
+
+	sm_create ("BSC1", 0, SM_FIFO, &BenchSm[1]);
+	sm_create ("BSC2", 0, SM_FIFO, &BenchSm[2]);
+
+	tid = bench_task ("BSPG", PONG_PRIO, T_PREEMPT, bench_smpong, 0);
+
+	for (BenchCount = 0, inx = 0; inx < BENCH_SAMPLES; inx++)
+	{
+		BenchStamp = gxk_h_clock ();
+
+		sm_v (BenchSm[1]);
+		sm_p (BenchSm[2], SM_WAIT, 0);
+	}
+
+	bench_report ("sm_contended");
+
+	t_delete (tid);
+	sm_delete (BenchSm[1]);
+	sm_delete (BenchSm[2]);
+}
+
+/******************************************************************************
+*						  
+* Name:				bench_evpong
+*
+* Type:				Function
+*
+* Description:		receive an event, time it, and answer
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void bench_evpong(ULONG *targs)
+
+{
+	ULONG got;
+
+	(void)targs;
+
+	for (;;)
+	{
+		if (ev_receive (EV_PING, EV_WAIT | EV_ANY, 0, &got) == 0)
+		{
+			BenchSample[BenchCount++] = gxk_h_clock () - BenchStamp;
+
+			ev_send (BenchCtl, EV_PONG);
+		}
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				bench_evwake
+*
+* Type:				Function
+*
+* Description:		ev_send to ev_receive latency of a blocked receiver
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void bench_evwake(void)
+
+{
+	ULONG inx;
+	ULONG tid;
+	ULONG got;
+
+	tid = bench_task ("BEPG", PONG_PRIO, T_PREEMPT, bench_evpong, 0);
+
+	for (BenchCount = 0, inx = 0; inx < BENCH_SAMPLES; inx++)
+	{
+		BenchStamp = gxk_h_clock ();
+
+		ev_send (tid, EV_PING);
+		ev_receive (EV_PONG, EV_WAIT | EV_ANY, 0, &got);
+	}
+
+	bench_report ("ev_wake");
+
+	t_delete (tid);
+}
+
+/******************************************************************************
+*						  
+* Name:				bench_tasklife
+*
+* Type:				Function
+*
+* Description:		cost of a t_create, t_start and t_delete cycle
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void bench_tasklife(void)
+
+{
+	ULONG inx;
+	ULONG tid;
+	ULONG runs;
+	LONGLONG start;
+
+	/*
+	 * a sample is kept only if the task got the core before it was
+	 * deleted, so each one includes the dispatch and switch back
+	 */
+
+	for (BenchCount = 0, inx = 0; inx < BENCH_SAMPLES; inx++)
+	{
+		runs = BenchRuns;
+		start = gxk_h_clock ();
+
+		if (t_create ("BTLF", PONG_PRIO, BENCH_STACK, BENCH_STACK, 0, &tid) == 0)
+		{
+			t_start (tid, T_PREEMPT, (void (*)())bench_idle, NULL);
+			t_delete (tid);
+
+			if (BenchRuns != runs)
+			{
+				BenchSample[BenchCount++] = gxk_h_clock () - start;
+			}
+		}
+	}
+
+	bench_report ("t_lifecycle");
+}
+
+/******************************************************************************
+*						  
+* Name:				bench_timer
+*
+* Type:				Function
+*
+* Description:		lateness of each tick of a one tick tm_evevery
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void bench_timer(void)
+
+{
+	ULONG inx;
+	ULONG tmid;
+	ULONG got;
+	LONGLONG first;
+	LONGLONG period;
+	LONGLONG late;
+
+	/*
+	 * each expiry is compared with where the first one puts it, so a
+	 * clock that drifts shows as lateness growing through the run
+	 */
+
+	period = (BenchFreq * TICK_MSEC) / 1000;
+
+	tm_evevery (1, EV_TICK, &tmid);
+
+	ev_receive (EV_TICK, EV_WAIT | EV_ANY, 0, &got);
+
+	first = gxk_h_clock ();
+
+	for (BenchCount = 0, inx = 1; inx <= BENCH_TICKS; inx++)
+	{
+		ev_receive (EV_TICK, EV_WAIT | EV_ANY, 0, &got);
+
+		late = gxk_h_clock () - (first + (LONGLONG)inx * period);
+
+		BenchSample[BenchCount++] = (late < 0) ? -late : late;
+	}
+
+	tm_cancel (tmid);
+
+	bench_report ("tm_jitter");
+}
+
+/******************************************************************************
+*						  
+* Name:				bench_main
+*
+* Type:				Function
+*
+* Description:		controller task, runs the suite and ends the program
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void bench_main(ULONG *targs)
+
+{
+	(void)targs;
+
+	t_ident (NULL, 0, &BenchCtl);
+
+	printf ("bench,metric,value,unit\n");
+
+	bench_qpingpong ();
+	bench_qthroughput ();
+	bench_smuncontended ();
+	bench_smcontended ();
+	bench_evwake ();
+	bench_tasklife ();
+	bench_timer ();
+
+	fflush (stdout);
+
+	gxk_h_evset (BenchDone);
+
+	for (;;)
+	{
+		tm_wkafter (100);
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				main
+*
+* Type:				Function
+*
+* Description:		start the kernel and wait for the suite to finish
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+int main(void)
+
+{
+	ULONG tid;
+
+	gxkInit ();
+
+	BenchFreq = gxk_h_freq ();
+	BenchDone = gxk_h_evcreate ();
+
+	if ((t_create ("BNCH", CTL_PRIO, BENCH_STACK, BENCH_STACK, 0, &tid) != 0) ||
+		(t_start (tid, T_PREEMPT, (void (*)())bench_main, NULL) != 0))
+	{
+		printf ("bench,error,1,count\n");
+		return (1);
+	}
+
+	gxk_h_evwait (BenchDone, INFINITE);
+
+	return (0);
+}
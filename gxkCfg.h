@@ -28,9 +28,44 @@
 #define MIN_TSTACK			256					/* min task stack size */
 #define MAX_TSTACK			4000				/* max task stack size */
 #define MAX_SSTACK			(MAX_TASK * 2000)	/* max stack available for all tasks */
+#define POOL_THREADS		8					/* task threads started ahead of t_start */
+#define NUM_CORES			1					/* host cores tasks are dispatched on, up to 16 */
+#define CORE_STEAL			1					/* cores take ready tasks waiting elsewhere */
+#define SCHED_POLICY		0					/* periodic tasks: 0 = priority, 1 = rate monotonic, 2 = EDF */
+#define PERIOD_PRIO			200					/* highest priority of periodic tasks */
+#define TSLICE_TICKS		10					/* quantum of a T_TSLICE task */
 
 #define MAX_Q				32
 #define MAX_BUF				2048
 
 #define MAX_SEM				128
+#define SEM_SPIN			64					/* sm_p polls before blocking */
+
+#define MAX_SELECT			16					/* entries one sl_wait may wait on */
+
+#define MAX_NODE			16					/* nodes a k_join system may have */
+#define NODE_BATCH			32					/* remote calls per transport frame */
+#define NODE_CACHE			64					/* remote *_ident results kept */
+#define NODE_TMO			200					/* msec to wait for a remote *_ident */
+
+#define MAX_MUTEX			64
+
+#define MAX_PART			32
+#define PT_MAGSIZE			8					/* per-task cache of a PT_MAG partition */
+
+#define MAX_REGION			8
+
+#define MAX_TIMER			1024				/* armed tm_ev* timers */
+#define TICK_MSEC			10					/* clock tick period */
+#define TICK_THREAD			1					/* 1 = kernel calls tm_tick itself */
+
+#define MAX_DEV				16					/* device major numbers */
+#define IO_SLOTS			32					/* de_submit requests queued per device, power of 2 */
+
+#define DEFER_SLOTS			64					/* asynchronous calls pending per core, power of 2 */
+
+#define TRACE_EVENTS		0					/* 1 = record kernel events for k_trace */
+#define TRACE_SLOTS			1024				/* trace records held per core, power of 2 */
+
+#define HOST_FIFO			0					/* 1 = POSIX host threads run SCHED_FIFO at task priority */
 
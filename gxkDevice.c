@@ -13,14 +13,22 @@
 *
 *	de_close
 *	de_cntrl
+*	de_done
+*	de_fetch
 *	de_init
+*	de_install
 *	de_open
 *	de_read
+*	de_submit
 *	de_write
 *
+*	gxk_de_init
+*
 * Private Functions:
 *
 *	gxkTmp
+*	io_call
+*	io_claim
 *
 * Modification History:
 * ----------------------------------------------------------- 
@@ -31,10 +39,198 @@
 **************************************END***************************************/
 
 #include <stdio.h>
-#include <windows.h>
 #include <stdlib.h>
-#include <process.h>
+#include "gxkHost.h"
 #include "gxkernel.h"
+#include "gxkCfg.h"
+#include "gxkSys.h"
+
+/********************************
+		LOCAL DECLARATIONS
+********************************/
+
+/*
+ * the switch table holds one driver per major device number; the
+ * minor number is the driver's business.  de_open, de_read and the
+ * rest call the driver entry on the calling task, as pSOS does.
+ *
+ * de_submit instead queues an iorequest on the device's ring and
+ * returns; the driver takes requests off with de_fetch and finishes
+ * each with de_done, which posts the completion with q_asend and
+ * ev_asend, so it may be called from the driver's interrupt or DMA
+ * context.  the request, its iopb and any buffer it names stay the
+ * caller's memory throughout, so a pt_getbuf buffer in the iopb is
+ * read or filled in place and comes back in the completion message.
+ *
+ * the ring works as the message queue rings do: a slot's sequence
+ * number is its submit position when free and one past it once a
+ * request is in, and both ends claim positions by compare-exchange
+ */
+
+#if ((IO_SLOTS & (IO_SLOTS - 1)) != 0)
+#error IO_SLOTS must be a power of two
+#endif
+
+typedef struct
+{
+	volatile LONG seq;			/* ring turn of this slot */
+	struct iorequest *req;
+} IOSLOT;
+
+typedef struct
+{
+	struct iojtab *drv;			/* NULL = no driver installed */
+	CACHE_ALIGN volatile LONG nextin;	/* next submit position */
+	CACHE_ALIGN volatile LONG nextout;	/* next fetch position */
+	IOSLOT ring[IO_SLOTS];
+} DEVDESC;
+
+/********************************
+		GLOBALS
+********************************/
+
+DEVDESC DevTbl[MAX_DEV];
+
+/******************************************************************************
+*						  
+* Name:				io_call
+*
+* Type:				Function
+*
+* Description:		call a driver entry on the calling task
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static ULONG io_call(ULONG dev, UINT func, void *iopb, void *retval)
+
+{
+	ULONG rtn;
+	struct iojtab *drv;
+	struct ioparms parms;
+	void (*entry)(struct ioparms *);
+
+	entry = NULL;
+
+	if (DE_MAJOR (dev) >= MAX_DEV)
+	{
+		rtn = ERR_IODN;
+	}
+	else if ((drv = DevTbl[DE_MAJOR (dev)].drv) == NULL)
+	{
+		rtn = ERR_NODR;
+	}
+	else
+	{
+		switch (func)
+		{
+		case IO_INIT:	entry = drv->dev_init;	break;
+		case IO_OPEN:	entry = drv->dev_open;	break;
+		case IO_CLOSE:	entry = drv->dev_close;	break;
+		case IO_READ:	entry = drv->dev_read;	break;
+		case IO_WRITE:	entry = drv->dev_write;	break;
+		case IO_CNTRL:	entry = drv->dev_cntrl;	break;
+		default:		break;
+		}
+
+		if (entry == NULL)
+		{
+			rtn = ERR_NODR;
+		}
+		else
+		{
+			parms.used = 0;
+			parms.tid = gxk_t_self ();
+			parms.in_dev = dev;
+			parms.status = 0;
+			parms.in_iopb = iopb;
+			parms.io_data_area = NULL;
+			parms.err = 0;
+			parms.out_retval = 0;
+
+			entry (&parms);
+
+			if (retval != NULL)
+			{
+				*(ULONG *)retval = parms.out_retval;
+			}
+
+			rtn = parms.err;
+		}
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				io_claim
+*
+* Type:				Function
+*
+* Description:		claim the next ring position to submit to or fetch from
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static UINT io_claim(DEVDESC *dev_p, volatile LONG *cursor, LONG turn, LONG *pos)
+
+{
+	LONG at;
+	LONG seq;
+	UINT rtn;
+
+	/*
+	 * turn is 0 to submit, 1 to fetch; a slot further behind than
+	 * that is the ring full or empty
+	 */
+
+	rtn = FALSE;
+
+	for (;;)
+	{
+		at = *cursor;
+		seq = dev_p->ring[at & (IO_SLOTS - 1)].seq;
+
+		if (seq == at + turn)
+		{
+			if (InterlockedCompareExchange (cursor, at + 1, at) == at)
+			{
+				*pos = at;
+				rtn = TRUE;
+				break;
+			}
+		}
+		else if (seq - (at + turn) < 0)
+		{
+			break;
+		}
+	}
+
+	return (rtn);
+}
 
 /******************************************************************************
 *						  
@@ -61,7 +257,7 @@
 ULONG de_close(ULONG dev, void *iopb, void *retval)
 
 {
-	return (0);
+	return (io_call (dev, IO_CLOSE, iopb, retval));
 }
 
 /******************************************************************************
@@ -89,7 +285,121 @@ ULONG de_close(ULONG dev, void *iopb, void *retval)
 ULONG de_cntrl(ULONG dev, void *iopb, void *retval)
 
 {
-	return (0);
+	return (io_call (dev, IO_CNTRL, iopb, retval));
+}
+
+/******************************************************************************
+*						  
+* Name:				de_done
+*
+* Type:				Function
+*
+* Description:		complete a request taken with de_fetch
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG de_done(struct iorequest *req, ULONG err, ULONG retval)
+
+{
+	ULONG rtn;
+	ULONG msg_buf[4];
+
+	rtn = 0;
+
+	/*
+	 * the completion message is the request itself, its error and
+	 * its return value
+	 */
+
+	req->err = err;
+	req->retval = retval;
+
+	if (req->qid != IO_NOQUEUE)
+	{
+		msg_buf[0] = (ULONG)req;
+		msg_buf[1] = err;
+		msg_buf[2] = retval;
+		msg_buf[3] = req->dev;
+
+		rtn = q_asend (req->qid, msg_buf);
+	}
+
+	if ((rtn == 0) && (req->events != 0))
+	{
+		rtn = ev_asend (req->tid, req->events);
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				de_fetch
+*
+* Type:				Function
+*
+* Description:		take the next request de_submit queued for a device
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG de_fetch(ULONG dev, struct iorequest **req)
+
+{
+	ULONG rtn;
+	LONG pos;
+	IOSLOT *slot;
+	DEVDESC *dev_p;
+
+	rtn = 0;
+
+	if (DE_MAJOR (dev) >= MAX_DEV)
+	{
+		rtn = ERR_IODN;
+	}
+	else
+	{
+		dev_p = &DevTbl[DE_MAJOR (dev)];
+
+		if (io_claim (dev_p, &dev_p->nextout, 1, &pos) == FALSE)
+		{
+			rtn = ERR_NOIOREQ;
+		}
+		else
+		{
+			slot = &dev_p->ring[pos & (IO_SLOTS - 1)];
+
+			*req = slot->req;
+
+			/* hand the slot to the submitter one lap ahead */
+			InterlockedExchange (&slot->seq, pos + IO_SLOTS);
+		}
+	}
+
+	return (rtn);
 }
 
 /******************************************************************************
@@ -117,7 +427,72 @@ ULONG de_cntrl(ULONG dev, void *iopb, void *retval)
 ULONG de_init(ULONG dev, void *iopb, void *retval, void **data_area)
 
 {
-	return (0);
+	/* no longer used, as in pSOS */
+	if (data_area != NULL)
+	{
+		*data_area = NULL;
+	}
+
+	return (io_call (dev, IO_INIT, iopb, retval));
+}
+
+/******************************************************************************
+*						  
+* Name:				de_install
+*
+* Type:				Function
+*
+* Description:		enter a driver in the switch table
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG de_install(ULONG major, struct iojtab *entry)
+
+{
+	ULONG rtn;
+	UINT inx;
+	DEVDESC *dev_p;
+
+	rtn = 0;
+
+	/*
+	 * may be called before gxkInit, which then runs the dev_init of
+	 * IO_AUTOINIT drivers; a NULL entry removes the driver
+	 */
+
+	if (major >= MAX_DEV)
+	{
+		rtn = ERR_IODN;
+	}
+	else
+	{
+		dev_p = &DevTbl[major];
+
+		dev_p->nextin = 0;
+		dev_p->nextout = 0;
+
+		for (inx = 0; inx < IO_SLOTS; inx++)
+		{
+			dev_p->ring[inx].seq = (LONG)inx;
+			dev_p->ring[inx].req = NULL;
+		}
+
+		dev_p->drv = entry;
+	}
+
+	return (rtn);
 }
 
 /******************************************************************************
@@ -145,7 +520,7 @@ ULONG de_init(ULONG dev, void *iopb, void *retval, void **data_area)
 ULONG de_open(ULONG dev, void *iopb, void *retval)
 
 {
-	return (0);
+	return (io_call (dev, IO_OPEN, iopb, retval));
 }
 
 /******************************************************************************
@@ -173,7 +548,96 @@ ULONG de_open(ULONG dev, void *iopb, void *retval)
 ULONG de_read(ULONG dev, void *iopb, void *retval)
 
 {
-	return (0);
+	return (io_call (dev, IO_READ, iopb, retval));
+}
+
+/******************************************************************************
+*						  
+* Name:				de_submit
+*
+* Type:				Function
+*
+* Description:		queue a read, write or control request for the driver
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG de_submit(ULONG dev, struct iorequest *req)
+
+{
+	ULONG rtn;
+	LONG pos;
+	IOSLOT *slot;
+	DEVDESC *dev_p;
+	struct ioparms parms;
+
+	rtn = 0;
+
+	if (DE_MAJOR (dev) >= MAX_DEV)
+	{
+		rtn = ERR_IODN;
+	}
+	else if (DevTbl[DE_MAJOR (dev)].drv == NULL)
+	{
+		rtn = ERR_NODR;
+	}
+	else if ((req->func != IO_READ) && (req->func != IO_WRITE) && (req->func != IO_CNTRL))
+	{
+		rtn = ERR_IOOP;
+	}
+	else
+	{
+		dev_p = &DevTbl[DE_MAJOR (dev)];
+
+		if (io_claim (dev_p, &dev_p->nextin, 0, &pos) == FALSE)
+		{
+			rtn = ERR_IOFULL;
+		}
+		else
+		{
+			req->dev = dev;
+			req->err = 0;
+			req->retval = 0;
+
+			slot = &dev_p->ring[pos & (IO_SLOTS - 1)];
+			slot->req = req;
+
+			/* publish, as ring_put does */
+			InterlockedExchange (&slot->seq, pos + 1);
+
+			/*
+			 * tell the driver there is work; it is not asked to do
+			 * the request here, only to get it started
+			 */
+
+			if (dev_p->drv->dev_start != NULL)
+			{
+				parms.used = 0;
+				parms.tid = gxk_t_self ();
+				parms.in_dev = dev;
+				parms.status = 0;
+				parms.in_iopb = NULL;
+				parms.io_data_area = NULL;
+				parms.err = 0;
+				parms.out_retval = 0;
+
+				dev_p->drv->dev_start (&parms);
+			}
+		}
+	}
+
+	return (rtn);
 }
 
 /******************************************************************************
@@ -201,5 +665,44 @@ ULONG de_read(ULONG dev, void *iopb, void *retval)
 ULONG de_write(ULONG dev, void *iopb, void *retval)
 
 {
+	return (io_call (dev, IO_WRITE, iopb, retval));
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_de_init
+*
+* Type:				Function
+*
+* Description:		initialize drivers installed IO_AUTOINIT
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_de_init(void)
+
+{
+	ULONG major;
+	ULONG retval;
+
+	for (major = 0; major < MAX_DEV; major++)
+	{
+		if ((DevTbl[major].drv != NULL) && (DevTbl[major].drv->flags & IO_AUTOINIT))
+		{
+			io_call (DE_DEV (major, 0), IO_INIT, NULL, &retval);
+		}
+	}
+
 	return (0);
 }
@@ -11,14 +11,19 @@
 *
 * Interface (public) Routines:
 *
+*	ev_asend
 *	ev_receive
 *	ev_send
 *
 *	gxk_ev_init
+*	gxk_ev_post
+*	gxk_ev_select
+*	gxk_ev_take
 *
 * Private Functions:
 *
-*	gxkTmp
+*	ev_take
+*	ev_wake
 *
 * Modification History:
 * ----------------------------------------------------------- 
@@ -29,24 +34,34 @@
 **************************************END***************************************/
 
 #include <stdio.h>
-#include <windows.h>
 #include <stdlib.h>
-#include <process.h>
+#include "gxkHost.h"
 #include "gxkernel.h"
 #include "gxkCfg.h"
-
-extern ULONG gxk_t_getTid(unsigned threadid, ULONG *tid);
+#include "gxkSys.h"
 
 /********************************
 		LOCAL DECLARATIONS
 ********************************/
 
+/*
+ * the pending mask is only ever changed by interlocked or and
+ * compare exchange, so senders post without the kernel lock and a
+ * receiver whose events are already in takes them the same way.
+ * the lock is needed only to block, and to wake a blocked receiver.
+ * a task in sl_wait is marked EV_SELECTING instead, and its events
+ * are taken for it by gxk_sl_post
+ */
+
+#define EV_SELECTING		2			/* waiting: task blocked in sl_wait */
+
 typedef struct
 {
 	ULONG evWait;
-	ULONG evPend;
+	volatile LONG evPend;
+	ULONG evGot;			/* taken for the receiver by the waking post */
 	UINT condition;
-	HANDLE gxkEvent;
+	volatile LONG waiting;	/* task blocked in ev_receive, or EV_SELECTING */
 } EVDESC;
 
 /********************************
@@ -55,6 +70,158 @@ typedef struct
 
 EVDESC EvTable[MAX_TASK];
 
+/******************************************************************************
+*						  
+* Name:				ev_take
+*
+* Type:				Function
+*
+* Description:		consume the wanted events if the condition is met
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static ULONG ev_take(ULONG tid, ULONG events, UINT condition)
+
+{
+	LONG pend;
+	ULONG got;
+
+	/*
+	 * the result is the events taken, 0 if the condition is not met;
+	 * a sender racing in between is picked up by the next round
+	 */
+
+	for (;;)
+	{
+		pend = EvTable[tid].evPend;
+		got = (ULONG)pend & events;
+
+		if ((condition == EV_ANY) ? (got == 0) : (got != events))
+		{
+			got = 0;
+			break;
+		}
+
+		if (InterlockedCompareExchange (&EvTable[tid].evPend, pend & ~(LONG)got, pend) == pend) break;
+	}
+
+	return (got);
+}
+
+/******************************************************************************
+*						  
+* Name:				ev_wake
+*
+* Type:				Function
+*
+* Description:		ready a task blocked in ev_receive
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void ev_wake(ULONG tid)
+
+{
+	ULONG got;
+
+	/*
+	 * called with the kernel locked; the events are taken here on
+	 * the receiver's behalf so no other consumer can get between
+	 * the post and the wake
+	 */
+
+	if (EvTable[tid].waiting == EV_SELECTING)
+	{
+		gxk_sl_post (SL_EVENT, tid, 0);
+	}
+	else if (EvTable[tid].waiting)
+	{
+		if ((got = ev_take (tid, EvTable[tid].evWait, EvTable[tid].condition)) != 0)
+		{
+			EvTable[tid].evGot = got;
+
+			InterlockedExchange (&EvTable[tid].waiting, FALSE);
+			gxk_t_ready ((UINT)tid, 0);
+		}
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				ev_asend
+*
+* Type:				Function
+*
+* Description:		ev_send from interrupt level
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG ev_asend(ULONG tid, ULONG events)
+
+{
+	ULONG rtn;
+	GXKDEFER *defer;
+
+	rtn = 0;
+
+	if (tid >= MAX_TASK)
+	{
+		rtn = ERR_OBJID;
+	}
+	else if ((defer = gxk_k_claim ()) == NULL)
+	{
+		rtn = ERR_ASFULL;
+	}
+	else
+	{
+		/*
+		 * the events are pending at once; only waking the receiver
+		 * waits for the kernel
+		 */
+
+		InterlockedOr (&EvTable[tid].evPend, (LONG)events);
+
+		gxk_k_post (defer, (EvTable[tid].waiting) ? DF_EVENT : DF_NOP, tid);
+	}
+
+	return (rtn);
+}
+
 /******************************************************************************
 *						  
 * Name:				ev_receive
@@ -81,69 +248,79 @@ ULONG ev_receive(ULONG events, ULONG flags, ULONG timeout, ULONG *events_r)
 
 {
 	ULONG rtn;
-	unsigned threadid;
 	ULONG tid;
 	DWORD msecTout;
 
-	threadid =  GetCurrentThreadId ();
+	rtn = 0;
+
+	tid = gxk_t_self ();
 	
-	if (gxk_t_getTid (threadid, &tid) == 0)
+	if (tid >= MAX_TASK)
+	{
+		rtn = ERR_OBJID;
+	}
+	else if (events == 0)
+	{
+		/*
+		 * report what is pending without consuming it
+		 */
+
+		*events_r = (ULONG)EvTable[tid].evPend;
+	}
+	else if ((*events_r = ev_take (tid, events, (flags & EV_ANY))) != 0)
 	{
+		/*
+		 * already pending; taken without the kernel lock
+		 */
+	}
+	else if (flags & EV_NOWAIT)
+	{
+		rtn = ERR_NOEVS;
+	}
+	else
+	{
+		gxk_k_lock ();
+
+		/*
+		 * set wait conditions
+		 */
+
 		EvTable[tid].evWait = events;
+		EvTable[tid].condition = (flags & EV_ANY);
+		EvTable[tid].evGot = 0;
 
 		/*
-		 * check for requested events already pending
+		 * announce the wait before looking again: a sender that
+		 * posted without seeing the flag is found by this take, any
+		 * later one wakes the task through ev_wake
 		 */
 
-		if ((((EvTable[tid].evPend & EvTable[tid].evWait) == EvTable[tid].evWait) &&
-			                                                (EvTable[tid].condition == EV_ALL)) ||
-			((EvTable[tid].evPend & EvTable[tid].evWait) && (EvTable[tid].condition == EV_ANY)))
-		{
-			*events_r = EvTable[tid].evPend;
-			EvTable[tid].evPend = EvTable[tid].evWait = 0;
-			rtn = 0;
-		}
-		else
+		InterlockedExchange (&EvTable[tid].waiting, TRUE);
+
+		if ((*events_r = ev_take (tid, events, EvTable[tid].condition)) == 0)
 		{
 			/*
-			 * requested event(s) not pending
-			 * request win32 wait according to conditions
+			 * convert timeout ticks to win32 time value (milliseconds)
 			 */
 
-			if (flags & EV_NOWAIT)
-			{
-				*events_r = 0;
-				rtn = ERR_NOEVS;
-			}
-			else
+			msecTout = gxk_tm_msec (timeout);
+
+			rtn = gxk_t_wait (NULL, msecTout);
+
+			/*
+			 * a post landing between the timeout and the relock
+			 * still took the events, so the wait was met
+			 */
+
+			if ((*events_r = EvTable[tid].evGot) != 0)
 			{
-				/*
-				 * set wait condtions
-				 */
-				
-				EvTable[tid].evWait = events;
-				EvTable[tid].condition = (flags & EV_ANY);
-
-				/*
-				 * convert timeout to win32 time value (milliseconds)
-				 */
-
-				msecTout = (timeout == 0) ? INFINITE : (DWORD)(timeout / 10);
-
-				/*
-				 * wait
-				 */
-
-				if (WaitForSingleObject (EvTable[tid].gxkEvent, msecTout) == WAIT_TIMEOUT)
-				{
-					rtn = ERR_TIMEOUT;
-				}
+				rtn = 0;
 			}
 		}
-	}
-	else
-	{
-		rtn = ERR_OBJID;
+
+		InterlockedExchange (&EvTable[tid].waiting, FALSE);
+
+		gxk_k_unlock ();
 	}
 
 	return (rtn);
@@ -175,44 +352,42 @@ ULONG ev_send(ULONG tid, ULONG events)
 
 {
 	ULONG rtn;
+	ULONG arg[4];
 
 	rtn = 0;
 	
 	if (tid < MAX_TASK)
 	{
-		/*
-		 * add new events to those currently pending
-		 */
-
-		EvTable[tid].evPend |= events;
+		GXK_TRACE (TR_EVSEND, tid, events, 0);
 
 		/*
-		 * signal waiting task, depending on wait condition
+		 * the or is a full barrier: either the receiver sees these
+		 * events when it looks again after announcing its wait, or
+		 * the wait is seen here
 		 */
 
-		if (EvTable[tid].condition == EV_ALL)
-		{
-			/*
-			 * wait for ALL
-			 */
+		InterlockedOr (&EvTable[tid].evPend, (LONG)events);
 
-			if ((EvTable[tid].evPend & EvTable[tid].evWait) == EvTable[tid].evWait)
-			{
-				SetEvent (EvTable[tid].gxkEvent);
-			}
-		}
-		else
+		if (EvTable[tid].waiting)
 		{
+			gxk_k_lock ();
+
+			ev_wake (tid);
+
 			/*
-			 * wait for ANY
+			 * preempts the caller if the receiver outranks it
 			 */
 
-			if (EvTable[tid].evPend & EvTable[tid].evWait)
-			{
-				SetEvent (EvTable[tid].gxkEvent);
-			}
+			gxk_k_unlock ();
 		}
 	}
+	else if (ND_NODE (tid) != 0)
+	{
+		arg[0] = events;
+		arg[1] = arg[2] = arg[3] = 0;
+
+		rtn = gxk_nd_send (ND_EVSEND, tid, arg);
+	}
 	else
 	{
 		rtn = ERR_OBJID;
@@ -221,6 +396,102 @@ ULONG ev_send(ULONG tid, ULONG events)
 	return (rtn);
 }
 
+/******************************************************************************
+*						  
+* Name:				gxk_ev_post
+*
+* Type:				Function
+*
+* Description:		add events for a task, waking it if its wait is met
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_ev_post(ULONG tid, ULONG events)
+
+{
+	/*
+	 * called with the kernel locked; add new events to those
+	 * currently pending and wake the task if its wait is met
+	 */
+
+	InterlockedOr (&EvTable[tid].evPend, (LONG)events);
+
+	ev_wake (tid);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_ev_select
+*
+* Type:				Function
+*
+* Description:		mark a task's events as waited for by sl_wait, or clear the mark
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_ev_select(ULONG tid, UINT on)
+
+{
+	/*
+	 * called with the kernel locked; senders seeing the mark enter
+	 * the kernel, where ev_wake hands the post to gxk_sl_post
+	 */
+
+	InterlockedExchange (&EvTable[tid].waiting, (on) ? EV_SELECTING : FALSE);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_ev_take
+*
+* Type:				Function
+*
+* Description:		take any of the wanted events for a task waiting in sl_wait
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_ev_take(ULONG tid, ULONG events)
+
+{
+	return (ev_take (tid, events, EV_ANY));
+}
+
 /******************************************************************************
 *						  
 * Name:				gxk_ev_init
@@ -248,17 +519,13 @@ ULONG gxk_ev_init()
 {
 	UINT inx;
 
-	/*
-	 * create the gxk event for each task
-	 */
-
 	for (inx = 0; inx < MAX_TASK; inx++)
 	{
 		EvTable[inx].evWait = 0;
 		EvTable[inx].evPend = 0;
+		EvTable[inx].evGot = 0;
 		EvTable[inx].condition = 0;
-		
-		EvTable[inx].gxkEvent = CreateEvent (NULL, FALSE, FALSE, NULL);
+		EvTable[inx].waiting = FALSE;
 	}
 
 	return (0);
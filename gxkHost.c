@@ -0,0 +1,1148 @@
+/************************************BEGIN*****************************************
+*                       COPYRIGHT %G% %U% BY GHWORKS, LLC 
+*                             ALL RIGHTS RESERVED
+*                         SPDX-License-Identifier: MIT
+* ********************************************************************************
+* Name:        gxkHost
+* Type:        C Source
+* File:        %M%
+* Version:     %I%
+* Description: Host Operating System Interface
+*
+* Interface (public) Routines:
+*
+*	gxk_h_affinity
+*	gxk_h_clock
+*	gxk_h_close
+*	gxk_h_cpu
+*	gxk_h_evcreate
+*	gxk_h_evset
+*	gxk_h_evwait
+*	gxk_h_exit
+*	gxk_h_freq
+*	gxk_h_lock
+*	gxk_h_lockinit
+*	gxk_h_setprio
+*	gxk_h_sleep
+*	gxk_h_stop
+*	gxk_h_thread
+*	gxk_h_threadid
+*	gxk_h_unlock
+*
+* Private Functions:
+*
+*	host_due
+*	host_release
+*	host_setup
+*	host_start
+*	host_stop
+*	host_wait
+*	host_wake
+*
+* Modification History:
+* -----------------------------------------------------------
+* Date		Initials		Change Description
+* -----------------------------------------------------------
+* 10/14/26	GVH				Created
+*
+**************************************END***************************************/
+
+#if !defined(_WIN32)
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "gxkHost.h"
+#include "gxkernel.h"
+#include "gxkCfg.h"
+#include "gxkSys.h"
+
+#if HOST_POSIX
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+
+/********************************
+		LOCAL DECLARATIONS
+********************************/
+
+#if HOST_POSIX
+
+#define HOST_STACK_MIN		(256 * 1024)		/* host threads need more than a task stack */
+#define HOST_SIGSUSP		(SIGRTMIN)			/* stops a thread for gxk_h_stop */
+
+/*
+ * an auto reset event: a set wakes one waiter, or the next to wait
+ */
+
+struct hostevent
+{
+	volatile int state;				/* 1 = set */
+	volatile int waiters;
+};
+
+/*
+ * a thread stops for good in host_stop, the handler of HOST_SIGSUSP;
+ * stopped lets gxk_h_stop return only once it has
+ */
+
+struct hostthread
+{
+	pthread_t pt;
+	volatile int tid;				/* host thread id, 0 until started */
+	unsigned (*entry)(void *);
+	void *arg;
+	volatile int refs;				/* creator and thread itself */
+	volatile int stopped;			/* 1 once in host_stop */
+};
+
+/********************************
+		GLOBALS
+********************************/
+
+static __thread struct hostthread *HostSelf = NULL;
+static __thread unsigned HostTid = 0;
+static pthread_once_t HostOnce = PTHREAD_ONCE_INIT;
+
+/******************************************************************************
+*						  
+* Name:				host_wait
+*
+* Type:				Function
+*
+* Description:		block on a futex word while it holds val
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static int host_wait(volatile int *addr, int val, const struct timespec *due)
+
+{
+	/*
+	 * due is absolute on CLOCK_MONOTONIC, NULL to wait for ever
+	 */
+
+	return ((int)syscall (SYS_futex, addr, FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG, val, due, NULL, FUTEX_BITSET_MATCH_ANY));
+}
+
+/******************************************************************************
+*						  
+* Name:				host_wake
+*
+* Type:				Function
+*
+* Description:		wake up to n threads blocked on a futex word
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void host_wake(volatile int *addr, int n)
+
+{
+	syscall (SYS_futex, addr, FUTEX_WAKE | FUTEX_PRIVATE_FLAG, n, NULL, NULL, 0);
+}
+
+/******************************************************************************
+*						  
+* Name:				host_due
+*
+* Type:				Function
+*
+* Description:		absolute CLOCK_MONOTONIC time msec from now
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void host_due(DWORD msec, struct timespec *due)
+
+{
+	clock_gettime (CLOCK_MONOTONIC, due);
+
+	due->tv_sec += msec / 1000;
+	due->tv_nsec += (long)(msec % 1000) * 1000000;
+
+	if (due->tv_nsec >= 1000000000)
+	{
+		due->tv_sec++;
+		due->tv_nsec -= 1000000000;
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				host_release
+*
+* Type:				Function
+*
+* Description:		drop a reference to a thread descriptor
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void host_release(void *arg)
+
+{
+	struct hostthread *t;
+
+	t = (struct hostthread *)arg;
+
+	if (__atomic_sub_fetch (&t->refs, 1, __ATOMIC_SEQ_CST) == 0)
+	{
+		free (t);
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				host_stop
+*
+* Type:				Function
+*
+* Description:		HOST_SIGSUSP handler, holds the thread for good
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void host_stop(int sig)
+
+{
+	struct hostthread *t;
+	int err;
+
+	(void)sig;
+
+	err = errno;
+	t = HostSelf;
+
+	if (t != NULL)
+	{
+		/*
+		 * the thread never leaves the handler, so its task cannot
+		 * run on; the host locks it holds stay held
+		 */
+
+		__atomic_store_n (&t->stopped, 1, __ATOMIC_SEQ_CST);
+		host_wake (&t->stopped, INT_MAX);
+
+		for (;;)
+		{
+			host_wait (&t->stopped, 1, NULL);
+		}
+	}
+
+	errno = err;
+}
+
+/******************************************************************************
+*						  
+* Name:				host_setup
+*
+* Type:				Function
+*
+* Description:		install the suspend handler, once
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void host_setup(void)
+
+{
+	struct sigaction act;
+
+	act.sa_handler = host_stop;
+	act.sa_flags = SA_RESTART;
+	sigemptyset (&act.sa_mask);
+
+	sigaction (HOST_SIGSUSP, &act, NULL);
+}
+
+/******************************************************************************
+*						  
+* Name:				host_start
+*
+* Type:				Function
+*
+* Description:		pthread entry of every host thread
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void *host_start(void *arg)
+
+{
+	struct hostthread *t;
+
+	t = (struct hostthread *)arg;
+
+	HostSelf = t;
+	HostTid = (unsigned)syscall (SYS_gettid);
+
+	pthread_cleanup_push (host_release, t);
+
+	__atomic_store_n (&t->tid, (int)HostTid, __ATOMIC_SEQ_CST);
+	host_wake (&t->tid, INT_MAX);
+
+	t->entry (t->arg);
+
+	pthread_cleanup_pop (1);
+
+	return (NULL);
+}
+
+#endif
+
+/******************************************************************************
+*						  
+* Name:				gxk_h_lockinit
+*
+* Type:				Function
+*
+* Description:		initialize a kernel lock
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_h_lockinit(GXKLOCK *lock)
+
+{
+#if HOST_WIN32
+	InitializeCriticalSection (lock);
+#else
+	lock->word = 0;
+	lock->owner = 0;
+	lock->depth = 0;
+#endif
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_h_lock
+*
+* Type:				Function
+*
+* Description:		take a kernel lock, again if already held
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_h_lock(GXKLOCK *lock)
+
+{
+#if HOST_WIN32
+	EnterCriticalSection (lock);
+#else
+	unsigned self;
+	int c;
+
+	self = gxk_h_threadid ();
+
+	/*
+	 * only this thread stores its own id in owner, so a relaxed load
+	 * tells whether it holds the lock already; the accesses are still
+	 * atomic as other threads store theirs
+	 */
+
+	if (__atomic_load_n (&lock->owner, __ATOMIC_RELAXED) == self)
+	{
+		lock->depth++;
+	}
+	else
+	{
+		if ((c = __sync_val_compare_and_swap (&lock->word, 0, 1)) != 0)
+		{
+			if (c != 2)
+			{
+				c = __atomic_exchange_n (&lock->word, 2, __ATOMIC_SEQ_CST);
+			}
+
+			while (c != 0)
+			{
+				host_wait (&lock->word, 2, NULL);
+				c = __atomic_exchange_n (&lock->word, 2, __ATOMIC_SEQ_CST);
+			}
+		}
+
+		__atomic_store_n (&lock->owner, self, __ATOMIC_RELAXED);
+		lock->depth = 1;
+	}
+#endif
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_h_unlock
+*
+* Type:				Function
+*
+* Description:		release one hold of a kernel lock
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_h_unlock(GXKLOCK *lock)
+
+{
+#if HOST_WIN32
+	LeaveCriticalSection (lock);
+#else
+	if (--lock->depth == 0)
+	{
+		__atomic_store_n (&lock->owner, 0, __ATOMIC_RELAXED);
+
+		if (__atomic_fetch_sub (&lock->word, 1, __ATOMIC_SEQ_CST) != 1)
+		{
+			__atomic_store_n (&lock->word, 0, __ATOMIC_SEQ_CST);
+			host_wake (&lock->word, 1);
+		}
+	}
+#endif
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_h_evcreate
+*
+* Type:				Function
+*
+* Description:		create an auto reset event, not set
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+GXKEVENT gxk_h_evcreate(void)
+
+{
+#if HOST_WIN32
+	return (CreateEvent (NULL, FALSE, FALSE, NULL));
+#else
+	return ((GXKEVENT)calloc (1, sizeof (struct hostevent)));
+#endif
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_h_evset
+*
+* Type:				Function
+*
+* Description:		set an event, waking one waiter
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_h_evset(GXKEVENT ev)
+
+{
+#if HOST_WIN32
+	SetEvent (ev);
+#else
+	__atomic_store_n (&ev->state, 1, __ATOMIC_SEQ_CST);
+
+	if (__atomic_load_n (&ev->waiters, __ATOMIC_SEQ_CST) != 0)
+	{
+		host_wake (&ev->state, 1);
+	}
+#endif
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_h_evwait
+*
+* Type:				Function
+*
+* Description:		wait up to msec for an event and reset it
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+UINT gxk_h_evwait(GXKEVENT ev, DWORD msec)
+
+{
+#if HOST_WIN32
+	return (WaitForSingleObject (ev, msec) != WAIT_TIMEOUT);
+#else
+	UINT rtn;
+	UINT expired;
+	struct timespec due;
+
+	if ((msec != INFINITE) && (msec != 0))
+	{
+		host_due (msec, &due);
+	}
+
+	rtn = FALSE;
+	expired = (msec == 0);
+
+	/*
+	 * a timed out wait still takes a set that came in meanwhile
+	 */
+
+	for (;;)
+	{
+		if (__sync_bool_compare_and_swap (&ev->state, 1, 0))
+		{
+			rtn = TRUE;
+			break;
+		}
+
+		if (expired)
+		{
+			break;
+		}
+
+		__atomic_add_fetch (&ev->waiters, 1, __ATOMIC_SEQ_CST);
+
+		if ((host_wait (&ev->state, 0, (msec == INFINITE) ? NULL : &due) == -1) && (errno == ETIMEDOUT))
+		{
+			expired = TRUE;
+		}
+
+		__atomic_sub_fetch (&ev->waiters, 1, __ATOMIC_SEQ_CST);
+	}
+
+	return (rtn);
+#endif
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_h_thread
+*
+* Type:				Function
+*
+* Description:		start a host thread
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+GXKTHREAD gxk_h_thread(unsigned (HOST_CALL *entry)(void *), void *arg, ULONG stack, unsigned *id)
+
+{
+#if HOST_WIN32
+	return ((GXKTHREAD)_beginthreadex (NULL, (unsigned)stack, entry, arg, 0, id));
+#else
+	struct hostthread *t;
+	pthread_attr_t attr;
+	int tid;
+
+	pthread_once (&HostOnce, host_setup);
+
+	if ((t = (struct hostthread *)calloc (1, sizeof (struct hostthread))) != NULL)
+	{
+		t->entry = entry;
+		t->arg = arg;
+		t->refs = 2;
+
+		pthread_attr_init (&attr);
+		pthread_attr_setdetachstate (&attr, PTHREAD_CREATE_DETACHED);
+		pthread_attr_setstacksize (&attr, (stack > HOST_STACK_MIN) ? stack : HOST_STACK_MIN);
+
+		if (pthread_create (&t->pt, &attr, host_start, t) != 0)
+		{
+			free (t);
+			t = NULL;
+		}
+		else
+		{
+			/*
+			 * the id is the thread's own to find out
+			 */
+
+			while ((tid = __atomic_load_n (&t->tid, __ATOMIC_SEQ_CST)) == 0)
+			{
+				host_wait (&t->tid, 0, NULL);
+			}
+
+			*id = (unsigned)tid;
+		}
+
+		pthread_attr_destroy (&attr);
+	}
+
+	return (t);
+#endif
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_h_close
+*
+* Type:				Function
+*
+* Description:		forget a host thread, which runs on
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_h_close(GXKTHREAD thread)
+
+{
+#if HOST_WIN32
+	CloseHandle (thread);
+#else
+	if (thread != NULL)
+	{
+		host_release (thread);
+	}
+#endif
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_h_exit
+*
+* Type:				Function
+*
+* Description:		end the calling host thread
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_h_exit(void)
+
+{
+#if HOST_WIN32
+	_endthreadex (0);
+#else
+	pthread_exit (NULL);
+#endif
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_h_stop
+*
+* Type:				Function
+*
+* Description:		stop a host thread for good, returning once it is stopped
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_h_stop(GXKTHREAD thread)
+
+{
+#if HOST_WIN32
+	CONTEXT ctx;
+
+	/*
+	 * SuspendThread is asynchronous; reading the context makes sure
+	 * the thread has actually stopped
+	 */
+
+	SuspendThread (thread);
+
+	ctx.ContextFlags = CONTEXT_INTEGER;
+	GetThreadContext (thread, &ctx);
+#else
+	if (thread != NULL)
+	{
+		pthread_kill (thread->pt, HOST_SIGSUSP);
+
+		while (__atomic_load_n (&thread->stopped, __ATOMIC_SEQ_CST) == 0)
+		{
+			host_wait (&thread->stopped, 0, NULL);
+		}
+	}
+#endif
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_h_affinity
+*
+* Type:				Function
+*
+* Description:		bind a host thread to one core
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_h_affinity(GXKTHREAD thread, UINT core)
+
+{
+#if HOST_WIN32
+	SetThreadAffinityMask (thread, (DWORD_PTR)1 << core);
+#else
+	cpu_set_t set;
+
+	if (thread != NULL)
+	{
+		CPU_ZERO (&set);
+		CPU_SET (core, &set);
+
+		pthread_setaffinity_np (thread->pt, sizeof (set), &set);
+	}
+#endif
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_h_setprio
+*
+* Type:				Function
+*
+* Description:		host priority of a thread running a task of priority prio
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_h_setprio(GXKTHREAD thread, ULONG prio)
+
+{
+#if HOST_POSIX && HOST_FIFO
+	struct sched_param param;
+	int lo;
+	int hi;
+
+	/*
+	 * task priorities spread evenly over the SCHED_FIFO range; a
+	 * process without the privilege keeps the threads as they are
+	 */
+
+	if (thread != NULL)
+	{
+		lo = sched_get_priority_min (SCHED_FIFO);
+		hi = sched_get_priority_max (SCHED_FIFO);
+
+		if (prio < MIN_PRIO)
+		{
+			prio = MIN_PRIO;
+		}
+
+		param.sched_priority = lo + (int)(((prio - MIN_PRIO) * (ULONG)(hi - lo)) / (MAX_PRIO - MIN_PRIO));
+
+		pthread_setschedparam (thread->pt, SCHED_FIFO, &param);
+	}
+#else
+	/*
+	 * dispatch decides which task threads run, the host needs no say
+	 */
+
+	(void)thread;
+	(void)prio;
+#endif
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_h_threadid
+*
+* Type:				Function
+*
+* Description:		host id of the calling thread
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+unsigned gxk_h_threadid(void)
+
+{
+#if HOST_WIN32
+	return ((unsigned)GetCurrentThreadId ());
+#else
+	if (HostTid == 0)
+	{
+		HostTid = (unsigned)syscall (SYS_gettid);
+	}
+
+	return (HostTid);
+#endif
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_h_cpu
+*
+* Type:				Function
+*
+* Description:		host core the caller runs on
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+UINT gxk_h_cpu(void)
+
+{
+#if HOST_WIN32
+	return ((UINT)GetCurrentProcessorNumber ());
+#else
+	int cpu;
+
+	cpu = sched_getcpu ();
+
+	return ((cpu < 0) ? 0 : (UINT)cpu);
+#endif
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_h_clock
+*
+* Type:				Function
+*
+* Description:		monotonic clock, in gxk_h_freq counts a second
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+LONGLONG gxk_h_clock(void)
+
+{
+#if HOST_WIN32
+	LARGE_INTEGER cnt;
+
+	QueryPerformanceCounter (&cnt);
+
+	return (cnt.QuadPart);
+#else
+	struct timespec now;
+
+	clock_gettime (CLOCK_MONOTONIC, &now);
+
+	return (((LONGLONG)now.tv_sec * 1000000000) + now.tv_nsec);
+#endif
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_h_freq
+*
+* Type:				Function
+*
+* Description:		counts a second of gxk_h_clock
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+LONGLONG gxk_h_freq(void)
+
+{
+#if HOST_WIN32
+	LARGE_INTEGER freq;
+
+	QueryPerformanceFrequency (&freq);
+
+	return (freq.QuadPart);
+#else
+	return (1000000000);
+#endif
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_h_sleep
+*
+* Type:				Function
+*
+* Description:		block the calling host thread for msec
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_h_sleep(DWORD msec)
+
+{
+#if HOST_WIN32
+	Sleep (msec);
+#else
+	struct timespec due;
+
+	if (msec == 0)
+	{
+		sched_yield ();
+	}
+	else if (msec == INFINITE)
+	{
+		for (;;)
+		{
+			pause ();
+		}
+	}
+	else
+	{
+		/*
+		 * an absolute deadline is not stretched by signals
+		 */
+
+		host_due (msec, &due);
+
+		while (clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &due, NULL) == EINTR)
+		{
+		}
+	}
+#endif
+}
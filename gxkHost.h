@@ -0,0 +1,128 @@
+/*******************************BEGIN**************************************
+*                       COPYRIGHT %G% %U% BY GHWORKS, LLC
+*                             ALL RIGHTS RESERVED
+*                         SPDX-License-Identifier: MIT
+**************************************************************************
+*
+* Name:        gxkHost.h
+* Type:        Include File
+* File:        %M%
+* Version:     %I%
+* Reference:
+* Description: Host operating system interface
+*
+*
+*
+* File Dependencies: types.h
+*
+* Modification History:
+* -----------------------------------------------------------
+* Date 	      Initials        Change Description
+* -----------------------------------------------------------
+* 10/14/26	  GVH			  Created
+*
+*******************************END****************************************/
+
+#ifndef _GXKHOST_H
+#define _GXKHOST_H
+
+/*
+ * everything the kernel asks of the host goes through the gxk_h_
+ * calls in gxkHost.c: the kernel lock, the events threads park on,
+ * threads themselves, the clock and sleeping.  a Win32 build maps
+ * them straight onto Win32; anywhere else they run natively on
+ * futexes and pthreads.  the interlocked operations keep their Win32
+ * names and are compiler builtins on the POSIX side
+ */
+
+#if defined(_WIN32)
+#define HOST_WIN32			1
+#define HOST_POSIX			0
+#else
+#define HOST_WIN32			0
+#define HOST_POSIX			1
+#endif
+
+#if HOST_WIN32
+
+#include <windows.h>
+#include <process.h>
+#include "types.h"
+
+#define HOST_CALL			__stdcall		/* thread entry convention */
+
+typedef CRITICAL_SECTION GXKLOCK;
+typedef HANDLE GXKEVENT;
+typedef HANDLE GXKTHREAD;
+
+#else
+
+#include <stddef.h>
+#include <stdint.h>
+#include "types.h"
+
+#define HOST_CALL
+
+typedef long LONG;							/* as wide as ULONG */
+typedef long long LONGLONG;
+typedef unsigned long long ULONGLONG;
+typedef unsigned int DWORD;
+typedef uintptr_t DWORD_PTR;
+typedef int BOOL;
+
+#define INFINITE			0xFFFFFFFF
+
+#define InterlockedIncrement(p)				__atomic_add_fetch ((p), 1, __ATOMIC_SEQ_CST)
+#define InterlockedDecrement(p)				__atomic_sub_fetch ((p), 1, __ATOMIC_SEQ_CST)
+#define InterlockedExchange(p, v)			__atomic_exchange_n ((p), (v), __ATOMIC_SEQ_CST)
+#define InterlockedExchangeAdd(p, v)		__atomic_fetch_add ((p), (v), __ATOMIC_SEQ_CST)
+#define InterlockedOr(p, v)					__atomic_fetch_or ((p), (v), __ATOMIC_SEQ_CST)
+#define InterlockedAnd(p, v)				__atomic_fetch_and ((p), (v), __ATOMIC_SEQ_CST)
+#define InterlockedCompareExchange(p, x, c)	__sync_val_compare_and_swap ((p), (c), (x))
+#define InterlockedCompareExchange64(p, x, c)	__sync_val_compare_and_swap ((p), (c), (x))
+
+#if defined(__i386__) || defined(__x86_64__)
+#define YieldProcessor()	__builtin_ia32_pause ()
+#else
+#define YieldProcessor()	__asm__ __volatile__ ("" ::: "memory")
+#endif
+
+/*
+ * the kernel lock is a futex word, 0 free, 1 held and 2 held with
+ * waiters, taken again by its owner without blocking
+ */
+
+typedef struct
+{
+	volatile int word;
+	volatile unsigned owner;		/* host thread id, 0 when free */
+	UINT depth;
+} GXKLOCK;
+
+typedef struct hostevent *GXKEVENT;
+typedef struct hostthread *GXKTHREAD;
+
+#endif
+
+void gxk_h_lockinit(GXKLOCK *lock);
+void gxk_h_lock(GXKLOCK *lock);
+void gxk_h_unlock(GXKLOCK *lock);
+
+GXKEVENT gxk_h_evcreate(void);
+void gxk_h_evset(GXKEVENT ev);
+UINT gxk_h_evwait(GXKEVENT ev, DWORD msec);
+
+GXKTHREAD gxk_h_thread(unsigned (HOST_CALL *entry)(void *), void *arg, ULONG stack, unsigned *id);
+void gxk_h_close(GXKTHREAD thread);
+void gxk_h_exit(void);
+void gxk_h_stop(GXKTHREAD thread);
+void gxk_h_affinity(GXKTHREAD thread, UINT core);
+void gxk_h_setprio(GXKTHREAD thread, ULONG prio);
+unsigned gxk_h_threadid(void);
+UINT gxk_h_cpu(void);
+
+LONGLONG gxk_h_clock(void);
+LONGLONG gxk_h_freq(void);
+void gxk_h_sleep(DWORD msec);
+
+#endif
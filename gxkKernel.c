@@ -11,11 +11,22 @@
 *
 * Interface (public) Routines:
 *
+*	i_return
 *	k_fatal
+*	k_trace
+*
+*	gxk_k_claim
+*	gxk_k_init
+*	gxk_k_leave
+*	gxk_k_lock
+*	gxk_k_post
+*	gxk_k_trace
+*	gxk_k_unlock
 *
 * Private Functions:
 *
 *	gxkTmp
+*	k_drain
 *
 * Modification History:
 * ----------------------------------------------------------- 
@@ -26,10 +37,106 @@
 **************************************END***************************************/
 
 #include <stdio.h>
-#include <windows.h>
 #include <stdlib.h>
-#include <process.h>
+#include "gxkHost.h"
 #include "gxkernel.h"
+#include "gxkCfg.h"
+#include "gxkSys.h"
+
+/********************************
+		LOCAL DECLARATIONS
+********************************/
+
+/*
+ * each core posts deferred work into a bounded ring of its own; as in
+ * the message queues, a slot's sequence number is its claim position
+ * when free and one past it once posted.  any number of callers claim
+ * with a compare-exchange on nextin, and only the kernel, holding its
+ * lock, takes slots off at nextout
+ */
+
+#if ((DEFER_SLOTS & (DEFER_SLOTS - 1)) != 0)
+#error DEFER_SLOTS must be a power of two
+#endif
+
+typedef struct
+{
+	CACHE_ALIGN volatile LONG nextin;	/* next slot to claim */
+	CACHE_ALIGN volatile LONG nextout;	/* next slot to run */
+	CACHE_ALIGN GXKDEFER slot[DEFER_SLOTS];
+} DEFERRING;
+
+/*
+ * trace records go into a ring per core the same way, claimed by
+ * whoever records an event and drained by k_trace.  a full ring drops
+ * the record and counts it, and the drain reports the count as a
+ * TR_LOST record so a host tool sees the gap
+ */
+
+#if ((TRACE_SLOTS & (TRACE_SLOTS - 1)) != 0)
+#error TRACE_SLOTS must be a power of two
+#endif
+
+typedef struct
+{
+	volatile LONG seq;			/* ring turn of this slot */
+	struct trevent rec;
+} TRACESLOT;
+
+typedef struct
+{
+	CACHE_ALIGN volatile LONG nextin;	/* next slot to claim */
+	CACHE_ALIGN volatile LONG nextout;	/* next record to drain */
+	volatile LONG lost;					/* records dropped since the last drain */
+	CACHE_ALIGN TRACESLOT slot[TRACE_SLOTS];
+} TRACERING;
+
+/********************************
+		GLOBALS
+********************************/
+
+GXKLOCK KernelLock;
+UINT KernelDepth;				/* lock nesting, changed only by its holder */
+
+DEFERRING DeferRing[NUM_CORES];
+
+#if TRACE_EVENTS
+TRACERING TraceRing[NUM_CORES];
+#endif
+
+/******************************************************************************
+*						  
+* Name:				i_return
+*
+* Type:				Function
+*
+* Description:		leave interrupt level, running the deferred work it posted
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void i_return(void)
+
+{
+	/*
+	 * entering and leaving the kernel runs whatever ev_asend, sm_av
+	 * and q_asend left behind, then dispatches a task they readied
+	 */
+
+	gxk_k_lock ();
+	gxk_k_unlock ();
+}
 
 /******************************************************************************
 *						  
@@ -56,5 +163,530 @@
 void  k_fatal(ULONG err_code, ULONG flags)
 
 {
-	printf ("FATAL FAULT: %x", err_code);
+#if TRACE_EVENTS
+	/*
+	 * reported on the trace channel rather than on the console
+	 */
+
+	gxk_k_trace (TR_FATAL, err_code, flags, 0);
+#else
+	(void)flags;
+
+	printf ("FATAL FAULT: %lx", (unsigned long)err_code);
+#endif
+}
+
+/******************************************************************************
+*						  
+* Name:				k_trace
+*
+* Type:				Function
+*
+* Description:		drain kernel trace records, oldest first on each core
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG k_trace(struct trevent *buf, ULONG max, ULONG *count)
+
+{
+	ULONG rtn;
+#if TRACE_EVENTS
+	UINT core;
+	LONG pos;
+	LONG lost;
+	TRACESLOT *slot;
+	TRACERING *ring;
+#endif
+
+	rtn = 0;
+	*count = 0;
+
+#if TRACE_EVENTS
+	/*
+	 * does not take the kernel lock, so a host tool may poll it from
+	 * any thread; several drainers each get different records
+	 */
+
+	for (core = 0; core < NUM_CORES; core++)
+	{
+		ring = &TraceRing[core];
+
+		if ((*count < max) && ((lost = ring->lost) != 0))
+		{
+			InterlockedExchangeAdd (&ring->lost, -lost);
+
+			buf[*count].stamp_hi = 0;
+			buf[*count].stamp_lo = 0;
+			buf[*count].core = core;
+			buf[*count].event = TR_LOST;
+			buf[*count].id = 0;
+			buf[*count].arg[0] = (ULONG)lost;
+			buf[*count].arg[1] = 0;
+			(*count)++;
+		}
+
+		while (*count < max)
+		{
+			pos = ring->nextout;
+			slot = &ring->slot[pos & (TRACE_SLOTS - 1)];
+
+			/* empty, or the next record is still being written */
+			if (slot->seq != pos + 1) break;
+
+			if (InterlockedCompareExchange (&ring->nextout, pos + 1, pos) == pos)
+			{
+				buf[*count] = slot->rec;
+				(*count)++;
+
+				InterlockedExchange (&slot->seq, pos + TRACE_SLOTS);
+			}
+		}
+	}
+#else
+	/* tracing is not configured in */
+	(void)buf;
+	(void)max;
+
+	rtn = ERR_SSFN;
+#endif
+
+	return (rtn);
+}
+/******************************************************************************
+*						  
+* Name:				k_drain
+*
+* Type:				Function
+*
+* Description:		run the deferred work posted on every core
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void k_drain(void)
+
+{
+	UINT core;
+	LONG pos;
+	GXKDEFER work;
+	GXKDEFER *slot;
+	DEFERRING *ring;
+
+	/*
+	 * called with the kernel locked, so there is one consumer; a slot
+	 * claimed but not yet posted holds back the ones behind it until
+	 * the next kernel exit
+	 */
+
+	for (core = 0; core < NUM_CORES; core++)
+	{
+		ring = &DeferRing[core];
+
+		for (;;)
+		{
+			pos = ring->nextout;
+			slot = &ring->slot[pos & (DEFER_SLOTS - 1)];
+
+			if (slot->seq != pos + 1) break;
+
+			work = *slot;
+
+			/* hand the slot back for the next lap */
+			ring->nextout = pos + 1;
+			InterlockedExchange (&slot->seq, pos + DEFER_SLOTS);
+
+			switch (work.op)
+			{
+			case DF_EVENT:
+				/* the events were added by ev_asend */
+				gxk_ev_post (work.id, 0);
+				break;
+
+			case DF_SEM:
+				gxk_sem_wake (work.id);
+				break;
+
+			case DF_QWAKE:
+				gxk_q_wake (work.id, work.arg[0]);
+				break;
+
+			case DF_QURGENT:
+				gxk_q_push (work.id, work.arg);
+				break;
+
+			default:
+				break;
+			}
+		}
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_k_lock
+*
+* Type:				Function
+*
+* Description:		enter the kernel
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_k_lock(void)
+
+{
+	gxk_h_lock (&KernelLock);
+
+	++KernelDepth;
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_k_unlock
+*
+* Type:				Function
+*
+* Description:		leave the kernel, switching tasks if a dispatch is pending
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_k_unlock(void)
+
+{
+	ULONG park;
+	UINT depth;
+
+	k_drain ();
+
+	/*
+	 * if the caller was preempted by whatever was made ready inside
+	 * the kernel, it gives up the CPU here and waits to be dispatched
+	 */
+
+	park = gxk_t_sched ();
+
+	depth = --KernelDepth;
+
+	gxk_h_unlock (&KernelLock);
+
+	if (park)
+	{
+		gxk_t_park (INFINITE);
+	}
+
+	/* leaving the kernel, the task takes signals sent to its ASR */
+	if (depth == 0)
+	{
+		gxk_as_run ();
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_k_claim
+*
+* Type:				Function
+*
+* Description:		claim a deferred work slot on the calling core
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+GXKDEFER *gxk_k_claim(void)
+
+{
+	LONG pos;
+	LONG seq;
+	GXKDEFER *slot;
+	GXKDEFER *rtn;
+	DEFERRING *ring;
+
+	/*
+	 * never blocks and never takes the kernel lock; NULL when the
+	 * ring is full.  a claimed slot must be posted with gxk_k_post,
+	 * as DF_NOP if it turns out there is nothing to do
+	 */
+
+	rtn = NULL;
+	ring = &DeferRing[gxk_h_cpu () % NUM_CORES];
+
+	for (;;)
+	{
+		pos = ring->nextin;
+		slot = &ring->slot[pos & (DEFER_SLOTS - 1)];
+		seq = slot->seq;
+
+		if (seq == pos)
+		{
+			if (InterlockedCompareExchange (&ring->nextin, pos + 1, pos) == pos)
+			{
+				slot->pos = pos;
+				rtn = slot;
+				break;
+			}
+		}
+		else if (seq - pos < 0)
+		{
+			/* not yet run on the last lap */
+			break;
+		}
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_k_post
+*
+* Type:				Function
+*
+* Description:		post a claimed slot for the kernel to run on its way out
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_k_post(GXKDEFER *slot, UINT op, ULONG id)
+
+{
+	/*
+	 * the caller fills slot->arg first for work that needs it
+	 */
+
+	slot->op = op;
+	slot->id = id;
+
+	InterlockedExchange (&slot->seq, slot->pos + 1);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_k_trace
+*
+* Type:				Function
+*
+* Description:		record a kernel event in the calling core's trace ring
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_k_trace(UINT event, ULONG id, ULONG arg0, ULONG arg1)
+
+{
+#if TRACE_EVENTS
+	UINT core;
+	LONG pos;
+	LONG seq;
+	LONGLONG cnt;
+	TRACESLOT *slot;
+	TRACERING *ring;
+
+	/*
+	 * called through GXK_TRACE, locked or not
+	 */
+
+	cnt = gxk_h_clock ();
+
+	core = gxk_h_cpu () % NUM_CORES;
+	ring = &TraceRing[core];
+
+	for (;;)
+	{
+		pos = ring->nextin;
+		slot = &ring->slot[pos & (TRACE_SLOTS - 1)];
+		seq = slot->seq;
+
+		if (seq == pos)
+		{
+			if (InterlockedCompareExchange (&ring->nextin, pos + 1, pos) == pos)
+			{
+				slot->rec.stamp_hi = (ULONG)(cnt >> 32);
+				slot->rec.stamp_lo = (ULONG)(cnt & 0xFFFFFFFF);
+				slot->rec.core = core;
+				slot->rec.event = event;
+				slot->rec.id = id;
+				slot->rec.arg[0] = arg0;
+				slot->rec.arg[1] = arg1;
+
+				InterlockedExchange (&slot->seq, pos + 1);
+				break;
+			}
+		}
+		else if (seq - pos < 0)
+		{
+			/* not yet drained on the last lap */
+			InterlockedIncrement (&ring->lost);
+			break;
+		}
+	}
+#else
+	(void)event;
+	(void)id;
+	(void)arg0;
+	(void)arg1;
+#endif
+}
+/******************************************************************************
+*						  
+* Name:				gxk_k_leave
+*
+* Type:				Function
+*
+* Description:		leave the kernel without a dispatch check
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_k_leave(void)
+
+{
+	--KernelDepth;
+
+	gxk_h_unlock (&KernelLock);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_k_init
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_k_init(void)
+
+{
+	UINT core;
+	UINT inx;
+
+	gxk_h_lockinit (&KernelLock);
+	KernelDepth = 0;
+
+	for (core = 0; core < NUM_CORES; core++)
+	{
+		DeferRing[core].nextin = 0;
+		DeferRing[core].nextout = 0;
+
+		for (inx = 0; inx < DEFER_SLOTS; inx++)
+		{
+			DeferRing[core].slot[inx].seq = (LONG)inx;
+		}
+
+#if TRACE_EVENTS
+		TraceRing[core].nextin = 0;
+		TraceRing[core].nextout = 0;
+		TraceRing[core].lost = 0;
+
+		for (inx = 0; inx < TRACE_SLOTS; inx++)
+		{
+			TraceRing[core].slot[inx].seq = (LONG)inx;
+		}
+#endif
+	}
+
+	return (0);
 }
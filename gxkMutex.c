@@ -0,0 +1,873 @@
+/************************************BEGIN*****************************************
+*                       COPYRIGHT %G% %U% BY GHWORKS, LLC 
+*                             ALL RIGHTS RESERVED
+*                         SPDX-License-Identifier: MIT
+* ********************************************************************************
+* Name:        gxkMutex
+* Type:        C Source
+* File:        %M%
+* Version:     %I%
+* Description: Mutex Services Interface
+*
+* Interface (public) Routines:
+*
+*	mu_create
+*	mu_delete
+*	mu_ident
+*	mu_lock
+*	mu_unlock
+*
+*	gxk_mu_ceiling
+*	gxk_mu_init
+*	gxk_mu_purge
+*
+* Private Functions:
+*
+*	mu_boost
+*	mu_handoff
+*	mu_reprio
+*
+* Modification History:
+* ----------------------------------------------------------- 
+* Date		Initials		Change Description
+* -----------------------------------------------------------
+* 10/14/26	GVH				Created
+*
+**************************************END***************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "gxkHost.h"
+#include "gxkernel.h"
+#include "gxkCfg.h"
+#include "gxkSys.h"
+
+/********************************
+		LOCAL DECLARATIONS
+********************************/
+
+/*
+ * the lock word is 0 when the mutex is free, else the owner's task
+ * id + 1, so an uncontended mu_lock / mu_unlock is one compare
+ * exchange and never enters the kernel.  a task that has to block
+ * sets MU_CONTEND under the kernel lock first; the owner's release
+ * then fails its exchange and hands the mutex straight to the first
+ * waiter.
+ *
+ * an owner runs at the highest of its own priority, the priority of
+ * the strongest task waiting on any MU_PRIO_INHERIT mutex it holds
+ * and the ceiling of any MU_PRIO_PROTECT mutex it holds.  a boost is
+ * passed along when the owner is itself waiting on a mutex
+ */
+
+#define MU_CONTEND			0x40000000			/* lock word: tasks waiting */
+#define MU_TIDMASK			0x0000FFFF
+
+#define MU_OWNER(lock)		((UINT)(((lock) & MU_TIDMASK) - 1))
+
+typedef struct
+{
+	CACHE_ALIGN volatile LONG lock;	/* 0, or owner + 1 and MU_CONTEND */
+	UINT count;					/* times locked by the owner */
+	UINT used;
+	GXKWAITQ waitq;				/* tasks blocked in mu_lock */
+	char name[4];
+	ULONG flags;
+	ULONG ceiling;				/* MU_PRIO_PROTECT priority */
+} MUDESC;
+
+/********************************
+		GLOBALS
+********************************/
+
+MUDESC MuTbl[MAX_MUTEX];
+
+/*
+ * mutex each task is blocked on, MAX_MUTEX if none
+ */
+
+UINT MuBlocked[MAX_TASK];
+
+/******************************************************************************
+*						  
+* Name:				gxk_mu_ceiling
+*
+* Type:				Function
+*
+* Description:		priority a task inherits from the mutexes it holds
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_mu_ceiling(UINT tid)
+
+{
+	ULONG top;
+	ULONG prio;
+	LONG lock;
+	UINT inx;
+	MUDESC *mu_p;
+
+	/*
+	 * called with the kernel locked; 0 if nothing is inherited.  an
+	 * inheriting mutex queues by priority, so its first waiter is
+	 * the strongest
+	 */
+
+	top = 0;
+
+	for (inx = 0; inx < MAX_MUTEX; inx++)
+	{
+		mu_p = &MuTbl[inx];
+		lock = mu_p->lock;
+
+		if ((mu_p->used == FALSE) || (lock == 0) || (MU_OWNER (lock) != tid))
+		{
+			continue;
+		}
+
+		if (mu_p->flags & MU_PRIO_PROTECT)
+		{
+			prio = mu_p->ceiling;
+		}
+		else if ((mu_p->flags & MU_PRIO_INHERIT) && (mu_p->waitq.head != MAX_TASK))
+		{
+			prio = gxk_t_prio (mu_p->waitq.head);
+		}
+		else
+		{
+			prio = 0;
+		}
+
+		if (prio > top)
+		{
+			top = prio;
+		}
+	}
+
+	return (top);
+}
+
+/******************************************************************************
+*						  
+* Name:				mu_boost
+*
+* Type:				Function
+*
+* Description:		lift a mutex owner to the priority of a new waiter
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void mu_boost(UINT tid, ULONG prio)
+
+{
+	UINT muid;
+	UINT hops;
+
+	/*
+	 * called with the kernel locked, before the waiter is queued;
+	 * owners further down the chain are lifted the same way
+	 */
+
+	for (hops = 0; (hops < MAX_TASK) && (tid < MAX_TASK); hops++)
+	{
+		if (gxk_t_prio (tid) >= prio)
+		{
+			break;
+		}
+
+		gxk_t_setprio (tid, prio);
+
+		muid = MuBlocked[tid];
+
+		if ((muid == MAX_MUTEX) || (MuTbl[muid].used == FALSE) ||
+			((MuTbl[muid].flags & MU_PRIO_INHERIT) == 0) || (MuTbl[muid].lock == 0))
+		{
+			break;
+		}
+
+		tid = MU_OWNER (MuTbl[muid].lock);
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				mu_reprio
+*
+* Type:				Function
+*
+* Description:		bring a mutex owner's priority up to date
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void mu_reprio(UINT tid)
+
+{
+	ULONG prio;
+	ULONG top;
+	UINT muid;
+	UINT hops;
+
+	/*
+	 * called with the kernel locked.  follow the chain of owners
+	 * while a change moves the task's place in a wait queue whose
+	 * owner inherits from it; a cycle is a deadlock and the hop
+	 * count bounds it
+	 */
+
+	for (hops = 0; (hops < MAX_TASK) && (tid < MAX_TASK); hops++)
+	{
+		prio = gxk_t_base (tid);
+		top = gxk_mu_ceiling (tid);
+
+		if (top > prio)
+		{
+			prio = top;
+		}
+
+		if (gxk_t_prio (tid) == prio)
+		{
+			break;
+		}
+
+		gxk_t_setprio (tid, prio);
+
+		muid = MuBlocked[tid];
+
+		if ((muid == MAX_MUTEX) || (MuTbl[muid].used == FALSE) ||
+			((MuTbl[muid].flags & MU_PRIO_INHERIT) == 0) || (MuTbl[muid].lock == 0))
+		{
+			break;
+		}
+
+		tid = MU_OWNER (MuTbl[muid].lock);
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				mu_handoff
+*
+* Type:				Function
+*
+* Description:		pass a released mutex to its first waiter
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void mu_handoff(MUDESC *mu_p)
+
+{
+	UINT next;
+
+	/*
+	 * called with the kernel locked.  the waiter owns the mutex
+	 * before it runs, so no task arriving meanwhile can barge in
+	 */
+
+	next = mu_p->waitq.head;
+
+	if (next == MAX_TASK)
+	{
+		mu_p->count = 0;
+		InterlockedExchange (&mu_p->lock, 0);
+	}
+	else
+	{
+		MuBlocked[next] = MAX_MUTEX;
+
+		mu_p->count = 1;
+		InterlockedExchange (&mu_p->lock, (LONG)(next + 1) | MU_CONTEND);
+
+		gxk_t_wake (&mu_p->waitq, 0);
+
+		if (mu_p->waitq.head == MAX_TASK)
+		{
+			InterlockedExchange (&mu_p->lock, (LONG)(next + 1));
+		}
+
+		mu_reprio (next);
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				mu_create
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG mu_create(char name[4], ULONG flags, ULONG ceiling, ULONG *muid)
+
+{
+	ULONG rtn;
+	ULONG inx;
+	MUDESC *mu_p;
+
+	inx = 0;
+
+	if ((flags & MU_PRIO_PROTECT) && ((ceiling < MIN_PRIO) || (ceiling > MAX_PRIO)))
+	{
+		return (ERR_PRIOR);
+	}
+
+	gxk_k_lock ();
+
+	while (inx < MAX_MUTEX)
+	{
+		if (MuTbl[inx].used == FALSE)
+			break;
+		++inx;
+	}
+
+	if (inx == MAX_MUTEX)
+	{
+		rtn = ERR_NOMUCB;
+	}
+	else
+	{
+		mu_p = &MuTbl[inx];
+
+		mu_p->used = TRUE;
+		mu_p->lock = 0;
+		mu_p->count = 0;
+		mu_p->flags = flags;
+		mu_p->ceiling = (flags & MU_PRIO_PROTECT) ? ceiling : 0;
+
+		/*
+		 * inheritance needs the strongest waiter at the head
+		 */
+
+		gxk_t_initq (&mu_p->waitq, (flags & (MU_PRIOR | MU_PRIO_INHERIT)) != 0);
+
+		mu_p->name[0] = name[0];
+		mu_p->name[1] = name[1];
+		mu_p->name[2] = name[2];
+		mu_p->name[3] = name[3];
+
+		gxk_nm_add (NM_MUTEX, mu_p->name, inx);
+
+		*muid = inx;
+
+		rtn = 0;
+	}
+
+	gxk_k_leave ();
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				mu_delete
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG mu_delete(ULONG muid)
+
+{
+	ULONG rtn;
+	UINT self;
+	LONG lock;
+	MUDESC *mu_p;
+
+	if (muid < MAX_MUTEX)
+	{
+		gxk_k_lock ();
+
+		mu_p = &MuTbl[muid];
+		self = gxk_t_self ();
+		lock = mu_p->lock;
+
+		if (mu_p->used == FALSE)
+		{
+			rtn = ERR_OBJDEL;
+		}
+		else if ((lock != 0) && (MU_OWNER (lock) != self))
+		{
+			rtn = ERR_MULOCKED;
+		}
+		else
+		{
+			gxk_nm_remove (NM_MUTEX, mu_p->name, muid);
+
+			mu_p->used = FALSE;
+			mu_p->name[0] = '\0';
+			mu_p->count = 0;
+			InterlockedExchange (&mu_p->lock, 0);
+
+			/*
+			 * tasks still waiting get ERR_MUKILLD; a caller that held
+			 * the mutex loses what it inherited through it
+			 */
+
+			if (gxk_t_flush (&mu_p->waitq, ERR_MUKILLD) != 0)
+			{
+				rtn = ERR_TATMUDEL;
+			}
+			else
+			{
+				rtn = 0;
+			}
+
+			if (lock != 0)
+			{
+				mu_reprio (self);
+			}
+		}
+
+		gxk_k_unlock ();
+	}
+	else
+	{
+		rtn = ERR_OBJID;
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				mu_ident
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG mu_ident(char name[4], ULONG node, ULONG *muid)
+
+{
+	ULONG rtn;
+
+	/* mutexes are never global, so only this node is searched */
+	(void)node;
+
+	gxk_k_lock ();
+	rtn = gxk_nm_find (NM_MUTEX, name, muid);
+	gxk_k_leave ();
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				mu_lock
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG mu_lock(ULONG muid, ULONG flags, ULONG timeout)
+
+{
+	ULONG rtn;
+	UINT self;
+	LONG lock;
+	MUDESC *mu_p;
+
+	if (muid >= MAX_MUTEX)
+	{
+		return (ERR_OBJID);
+	}
+
+	mu_p = &MuTbl[muid];
+	self = gxk_t_self ();
+	lock = mu_p->lock;
+
+	/*
+	 * mutexes are owned by tasks
+	 */
+
+	if (self >= MAX_TASK)
+	{
+		rtn = ERR_OBJID;
+	}
+	else if (mu_p->used == FALSE)
+	{
+		rtn = ERR_OBJDEL;
+	}
+	else if ((lock != 0) && (MU_OWNER (lock) == self))
+	{
+		if (mu_p->flags & MU_RECURSIVE)
+		{
+			++mu_p->count;
+			rtn = 0;
+		}
+		else
+		{
+			rtn = ERR_MURECURSE;
+		}
+	}
+	else if (((mu_p->flags & MU_PRIO_PROTECT) == 0) &&
+			 (InterlockedCompareExchange (&mu_p->lock, (LONG)(self + 1), 0) == 0))
+	{
+		mu_p->count = 1;
+		rtn = 0;
+	}
+	else
+	{
+		gxk_k_lock ();
+
+		for (;;)
+		{
+			lock = mu_p->lock;
+
+			if (mu_p->used == FALSE)
+			{
+				rtn = ERR_OBJDEL;
+				break;
+			}
+
+			if (lock == 0)
+			{
+				if ((mu_p->flags & MU_PRIO_PROTECT) && (gxk_t_prio (self) > mu_p->ceiling))
+				{
+					rtn = ERR_CEILING;
+					break;
+				}
+
+				if (InterlockedCompareExchange (&mu_p->lock, (LONG)(self + 1), 0) == 0)
+				{
+					/* a protected mutex lifts its owner at once */
+					mu_p->count = 1;
+					mu_reprio (self);
+
+					rtn = 0;
+					break;
+				}
+
+				continue;
+			}
+
+			if (flags & MU_NOWAIT)
+			{
+				rtn = ERR_NOMUTEX;
+				break;
+			}
+
+			/*
+			 * flag the owner's release into the kernel, then block;
+			 * the owner takes on the caller's priority if it is less
+			 */
+
+			if (InterlockedCompareExchange (&mu_p->lock, lock | MU_CONTEND, lock) != lock)
+			{
+				continue;
+			}
+
+			MuBlocked[self] = (UINT)muid;
+
+			if (mu_p->flags & MU_PRIO_INHERIT)
+			{
+				mu_boost (MU_OWNER (lock), gxk_t_prio (self));
+			}
+
+			rtn = gxk_t_wait (&mu_p->waitq, gxk_tm_msec (timeout));
+
+			MuBlocked[self] = MAX_MUTEX;
+
+			/*
+			 * given up on: the owner no longer inherits from the
+			 * caller.  on success the releaser made the caller owner
+			 */
+
+			if ((rtn != 0) && mu_p->used && (mu_p->lock != 0))
+			{
+				mu_reprio (MU_OWNER (mu_p->lock));
+			}
+
+			break;
+		}
+
+		gxk_k_unlock ();
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				mu_unlock
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG mu_unlock(ULONG muid)
+
+{
+	ULONG rtn;
+	UINT self;
+	LONG lock;
+	MUDESC *mu_p;
+
+	if (muid >= MAX_MUTEX)
+	{
+		return (ERR_OBJID);
+	}
+
+	mu_p = &MuTbl[muid];
+	self = gxk_t_self ();
+	lock = mu_p->lock;
+
+	if (mu_p->used == FALSE)
+	{
+		rtn = ERR_OBJDEL;
+	}
+	else if ((self >= MAX_TASK) || (lock == 0) || (MU_OWNER (lock) != self))
+	{
+		rtn = ERR_NOTOWNER;
+	}
+	else if (mu_p->count > 1)
+	{
+		--mu_p->count;
+		rtn = 0;
+	}
+	else
+	{
+		/*
+		 * nobody waiting and nothing inherited: just clear the word
+		 */
+
+		mu_p->count = 0;
+
+		if (((mu_p->flags & MU_PRIO_PROTECT) == 0) &&
+			(InterlockedCompareExchange (&mu_p->lock, 0, (LONG)(self + 1)) == (LONG)(self + 1)))
+		{
+		}
+		else
+		{
+			gxk_k_lock ();
+
+			mu_handoff (mu_p);
+			mu_reprio (self);
+
+			gxk_k_unlock ();
+		}
+
+		rtn = 0;
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_mu_purge
+*
+* Type:				Function
+*
+* Description:		release what a deleted task held or waited on
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_mu_purge(ULONG tid)
+
+{
+	UINT muid;
+	LONG lock;
+
+	/*
+	 * called with the kernel locked, after the task has left any
+	 * wait queue
+	 */
+
+	muid = MuBlocked[tid];
+
+	if (muid != MAX_MUTEX)
+	{
+		MuBlocked[tid] = MAX_MUTEX;
+
+		if (MuTbl[muid].used && (MuTbl[muid].lock != 0))
+		{
+			mu_reprio (MU_OWNER (MuTbl[muid].lock));
+		}
+	}
+
+	for (muid = 0; muid < MAX_MUTEX; muid++)
+	{
+		lock = MuTbl[muid].lock;
+
+		if (MuTbl[muid].used && (lock != 0) && (MU_OWNER (lock) == tid))
+		{
+			mu_handoff (&MuTbl[muid]);
+		}
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_mu_init
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_mu_init(void)
+
+{
+	UINT inx;
+
+	for (inx = 0; inx < MAX_MUTEX; inx++)
+	{
+		MuTbl[inx].name[0] = '\0';
+		MuTbl[inx].lock = 0;
+		MuTbl[inx].count = 0;
+		MuTbl[inx].flags = 0;
+		MuTbl[inx].ceiling = 0;
+		MuTbl[inx].used = FALSE;
+		gxk_t_initq (&MuTbl[inx].waitq, FALSE);
+	}
+
+	for (inx = 0; inx < MAX_TASK; inx++)
+	{
+		MuBlocked[inx] = MAX_MUTEX;
+	}
+
+	return (0);
+}
@@ -0,0 +1,319 @@
+/************************************BEGIN*****************************************
+*                       COPYRIGHT %G% %U% BY GHWORKS, LLC 
+*                             ALL RIGHTS RESERVED
+*                         SPDX-License-Identifier: MIT
+* ********************************************************************************
+* Name:        gxkName
+* Type:        C Source
+* File:        %M%
+* Version:     %I%
+* Description: Object Name Registry
+*
+* Interface (public) Routines:
+*
+*	gxk_nm_add
+*	gxk_nm_find
+*	gxk_nm_init
+*	gxk_nm_remove
+*
+* Private Functions:
+*
+*	name_hash
+*	name_key
+*
+* Modification History:
+* ----------------------------------------------------------- 
+* Date		Initials		Change Description
+* -----------------------------------------------------------
+* 10/14/26	GVH				Created
+*
+**************************************END***************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "gxkHost.h"
+#include "gxkernel.h"
+#include "gxkCfg.h"
+#include "gxkSys.h"
+
+/********************************
+		LOCAL DECLARATIONS
+********************************/
+
+/*
+ * each object class has an open addressed table keyed by the four
+ * name bytes taken as one 32 bit word; linear probing with backward
+ * shift on removal, so there are no tombstones to sweep
+ */
+
+#define NAME_BITS		8
+#define NAME_SLOTS		(1 << NAME_BITS)		/* at least twice any table */
+
+#define NO_OBJ			0xFFFFFFFF				/* empty slot */
+
+#if ((2 * MAX_TASK) > NAME_SLOTS) || ((2 * MAX_Q) > NAME_SLOTS) || ((2 * MAX_SEM) > NAME_SLOTS) || ((2 * MAX_MUTEX) > NAME_SLOTS)
+#error NAME_SLOTS too small for the configured object tables
+#endif
+
+typedef struct
+{
+	ULONG key;
+	ULONG id;
+} NAMEENT;
+
+/********************************
+		GLOBALS
+********************************/
+
+NAMEENT NameTbl[NM_CLASSES][NAME_SLOTS];
+
+/******************************************************************************
+*						  
+* Name:				name_key
+*
+* Type:				Function
+*
+* Description:		pack an object name into its 32 bit key
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static ULONG name_key(char name[4])
+
+{
+	return (((ULONG)(UCHAR)name[0] << 24) |
+			((ULONG)(UCHAR)name[1] << 16) |
+			((ULONG)(UCHAR)name[2] << 8) |
+			 (ULONG)(UCHAR)name[3]);
+}
+
+/******************************************************************************
+*						  
+* Name:				name_hash
+*
+* Type:				Function
+*
+* Description:		home slot of a key
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static UINT name_hash(ULONG key)
+
+{
+	return ((((UINT)key * 2654435761U) >> (32 - NAME_BITS)) & (NAME_SLOTS - 1));
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_nm_add
+*
+* Type:				Function
+*
+* Description:		enter an object name in its class table
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_nm_add(UINT cls, char name[4], ULONG id)
+
+{
+	NAMEENT *tbl;
+	ULONG key;
+	UINT inx;
+
+	/*
+	 * called with the kernel locked; duplicate names are kept in
+	 * creation order along the probe chain
+	 */
+
+	tbl = NameTbl[cls];
+	key = name_key (name);
+
+	for (inx = name_hash (key); tbl[inx].id != NO_OBJ; inx = (inx + 1) & (NAME_SLOTS - 1))
+	{
+	}
+
+	tbl[inx].key = key;
+	tbl[inx].id = id;
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_nm_remove
+*
+* Type:				Function
+*
+* Description:		drop an object name from its class table
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_nm_remove(UINT cls, char name[4], ULONG id)
+
+{
+	NAMEENT *tbl;
+	ULONG key;
+	UINT inx;
+	UINT next;
+	UINT home;
+
+	tbl = NameTbl[cls];
+	key = name_key (name);
+
+	for (inx = name_hash (key); tbl[inx].id != NO_OBJ; inx = (inx + 1) & (NAME_SLOTS - 1))
+	{
+		if ((tbl[inx].key == key) && (tbl[inx].id == id)) break;
+	}
+
+	if (tbl[inx].id == NO_OBJ)
+	{
+		return;
+	}
+
+	/*
+	 * pull later entries of the cluster back over the hole unless
+	 * that would move them in front of their home slot
+	 */
+
+	for (next = (inx + 1) & (NAME_SLOTS - 1); tbl[next].id != NO_OBJ; next = (next + 1) & (NAME_SLOTS - 1))
+	{
+		home = name_hash (tbl[next].key);
+
+		if (((next - home) & (NAME_SLOTS - 1)) >= ((next - inx) & (NAME_SLOTS - 1)))
+		{
+			tbl[inx] = tbl[next];
+			inx = next;
+		}
+	}
+
+	tbl[inx].id = NO_OBJ;
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_nm_find
+*
+* Type:				Function
+*
+* Description:		look up an object by name
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_nm_find(UINT cls, char name[4], ULONG *id)
+
+{
+	NAMEENT *tbl;
+	ULONG key;
+	UINT inx;
+
+	tbl = NameTbl[cls];
+	key = name_key (name);
+
+	for (inx = name_hash (key); tbl[inx].id != NO_OBJ; inx = (inx + 1) & (NAME_SLOTS - 1))
+	{
+		if (tbl[inx].key == key)
+		{
+			*id = tbl[inx].id;
+			return (0);
+		}
+	}
+
+	return (ERR_OBJNF);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_nm_init
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_nm_init(void)
+
+{
+	UINT cls;
+	UINT inx;
+
+	for (cls = 0; cls < NM_CLASSES; cls++)
+	{
+		for (inx = 0; inx < NAME_SLOTS; inx++)
+		{
+			NameTbl[cls][inx].key = 0;
+			NameTbl[cls][inx].id = NO_OBJ;
+		}
+	}
+
+	return (0);
+}
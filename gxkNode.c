@@ -0,0 +1,1297 @@
+/************************************BEGIN*****************************************
+*                       COPYRIGHT %G% %U% BY GHWORKS, LLC 
+*                             ALL RIGHTS RESERVED
+*                         SPDX-License-Identifier: MIT
+* ********************************************************************************
+* Name:        gxkNode
+* Type:        C Source
+* File:        %M%
+* Version:     %I%
+* Description: Multi-processor Node Services Interface
+*
+* Interface (public) Routines:
+*
+*	k_join
+*	k_receive
+*	k_terminate
+*
+*	gxk_nd_export
+*	gxk_nd_flush
+*	gxk_nd_ident
+*	gxk_nd_init
+*	gxk_nd_send
+*	gxk_nd_unexport
+*
+* Private Functions:
+*
+*	nd_apply
+*	nd_ask
+*	nd_forget
+*	nd_lookup
+*	nd_name
+*	nd_put
+*	nd_remember
+*	nd_roster
+*	nd_take
+*
+* Modification History:
+* ----------------------------------------------------------- 
+* Date		Initials		Change Description
+* -----------------------------------------------------------
+* 10/14/26	GVH				Created
+*
+**************************************END***************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "gxkHost.h"
+#include "gxkernel.h"
+#include "gxkCfg.h"
+#include "gxkSys.h"
+
+/********************************
+		LOCAL DECLARATIONS
+********************************/
+
+/*
+ * kernels on several boards join one system with k_join, handing over
+ * the transport as ki_send; frames that arrive are given back with
+ * k_receive.  a frame is a batch of fixed size packets, host order.
+ * calls on remote objects are fire and forget: each is added to the
+ * frame for its node, which goes out when full or on the next clock
+ * tick, so a busy sender pays one transport send per NODE_BATCH
+ * calls and errors at the far end are not reported back.  ident
+ * requests and replies go out at once.  ki_send is called with that
+ * node's link held, so frames to a node leave in order
+ */
+
+#if (MAX_NODE > 31)
+#error MAX_NODE must be 31 or less
+#endif
+
+#define ND_IDENT		5			/* arg[0] class, arg[1] name, arg[2] task, arg[3] ask */
+#define ND_REPLY		6			/* id found, arg[0] 0 or ERR_OBJNF, arg[2..3] as asked */
+#define ND_FORGET		7			/* arg[0] class, arg[1] name withdrawn */
+#define ND_JOIN			8			/* sender has joined */
+#define ND_HELLO		9			/* sender was in already */
+#define ND_EXIT			10			/* sender has left */
+#define ND_TERM			11			/* receiver is to leave, arg[0] fcode */
+
+#define ND_FREE			0			/* name entry states */
+#define ND_LIVE			1
+#define ND_GONE			2			/* withdrawn, peers not yet told */
+
+#define ND_EXPORTS		(MAX_TASK + MAX_Q + MAX_SEM)
+
+#define ND_FRAMELEN(n)	((ULONG)(sizeof (NDFRAME) - ((NODE_BATCH - (n)) * sizeof (NDPACKET))))
+
+typedef struct
+{
+	ULONG op;
+	ULONG id;
+	ULONG arg[4];
+} NDPACKET;
+
+typedef struct
+{
+	ULONG from;
+	ULONG count;
+	NDPACKET pkt[NODE_BATCH];
+} NDFRAME;
+
+typedef struct
+{
+	GXKLOCK lock;
+	NDFRAME out;				/* frame being filled */
+} NDLINK;
+
+typedef struct
+{
+	UINT state;
+	UINT cls;
+	ULONG name;					/* packed by nd_name */
+	ULONG id;
+} NDNAME;
+
+typedef struct
+{
+	UINT busy;
+	ULONG seq;					/* numbers the ask, so late replies are dropped */
+	ULONG asked;				/* nodes asked */
+	ULONG replies;				/* nodes that did not have it */
+	ULONG code;
+	ULONG id;
+} NDASK;
+
+/********************************
+		GLOBALS
+********************************/
+
+struct mpcfg NodeCfg;
+volatile ULONG NodeNum;			/* this node, 0 until joined */
+UINT NodeUp[MAX_NODE + 1];
+
+NDLINK NodeLink[MAX_NODE + 1];
+NDNAME NodeCache[NODE_CACHE];	/* remote ident results */
+UINT CacheNext;
+NDNAME NodeExport[ND_EXPORTS];	/* global objects of this node */
+NDASK NodeAsk[MAX_TASK];
+
+/******************************************************************************
+*						  
+* Name:				nd_name
+*
+* Type:				Function
+*
+* Description:		pack an object name into a word
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static ULONG nd_name(char name[4])
+
+{
+	return (((ULONG)(unsigned char)name[0] << 24) | ((ULONG)(unsigned char)name[1] << 16) |
+			((ULONG)(unsigned char)name[2] << 8) | (ULONG)(unsigned char)name[3]);
+}
+
+/******************************************************************************
+*						  
+* Name:				nd_put
+*
+* Type:				Function
+*
+* Description:		add a packet to the frame for a node, sending it when full
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void nd_put(ULONG node, NDPACKET *pkt, UINT now)
+
+{
+	NDLINK *ln;
+	UINT held;
+
+	/*
+	 * called with the kernel unlocked; now sends the frame at once.
+	 * a frame left part full is sent by gxk_nd_flush at the next
+	 * tick, which the clock is kept running for
+	 */
+
+	ln = &NodeLink[node];
+
+	gxk_h_lock (&ln->lock);
+
+	ln->out.pkt[ln->out.count++] = *pkt;
+
+	if ((now) || (ln->out.count == NODE_BATCH))
+	{
+		ln->out.from = NodeNum;
+
+		NodeCfg.ki_send (node, &ln->out, ND_FRAMELEN (ln->out.count));
+
+		ln->out.count = 0;
+	}
+
+	held = (ln->out.count == 1);
+
+	gxk_h_unlock (&ln->lock);
+
+	if (held)
+	{
+		gxk_k_lock ();
+		gxk_tm_batch ();
+		gxk_k_leave ();
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				nd_roster
+*
+* Type:				Function
+*
+* Description:		tell the application a node has joined or left
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void nd_roster(ULONG node, ULONG change)
+
+{
+	if ((NodeCfg.flags & KIROSTER) && (NodeCfg.ki_roster != NULL))
+	{
+		NodeCfg.ki_roster (node, change);
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				nd_lookup
+*
+* Type:				Function
+*
+* Description:		find a cached remote ident result
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static UINT nd_lookup(UINT cls, ULONG name, ULONG node)
+
+{
+	UINT inx;
+	NDNAME *nm;
+
+	/*
+	 * called with the kernel locked; node 0 takes the object from
+	 * whichever node it was found on
+	 */
+
+	for (inx = 0; inx < NODE_CACHE; inx++)
+	{
+		nm = &NodeCache[inx];
+
+		if ((nm->state == ND_LIVE) && (nm->cls == cls) && (nm->name == name) &&
+			((node == 0) || (ND_NODE (nm->id) == node)))
+		{
+			break;
+		}
+	}
+
+	return (inx);
+}
+
+/******************************************************************************
+*						  
+* Name:				nd_remember
+*
+* Type:				Function
+*
+* Description:		cache a remote ident result
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void nd_remember(UINT cls, ULONG name, ULONG id)
+
+{
+	UINT inx;
+	NDNAME *nm;
+
+	/*
+	 * called with the kernel locked; entries are replaced in turn
+	 */
+
+	if ((inx = nd_lookup (cls, name, ND_NODE (id))) == NODE_CACHE)
+	{
+		inx = CacheNext;
+		CacheNext = (CacheNext + 1) % NODE_CACHE;
+	}
+
+	nm = &NodeCache[inx];
+
+	nm->state = ND_LIVE;
+	nm->cls = cls;
+	nm->name = name;
+	nm->id = id;
+}
+
+/******************************************************************************
+*						  
+* Name:				nd_forget
+*
+* Type:				Function
+*
+* Description:		drop cached results for objects of a node
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void nd_forget(ULONG node, UINT cls, ULONG name)
+
+{
+	UINT inx;
+	NDNAME *nm;
+
+	/*
+	 * called with the kernel locked; name 0 drops all of the node's
+	 */
+
+	for (inx = 0; inx < NODE_CACHE; inx++)
+	{
+		nm = &NodeCache[inx];
+
+		if ((nm->state == ND_LIVE) && (ND_NODE (nm->id) == node) &&
+			((name == 0) || ((nm->cls == cls) && (nm->name == name))))
+		{
+			nm->state = ND_FREE;
+		}
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				nd_apply
+*
+* Type:				Function
+*
+* Description:		make a remote call on an object of this node
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static ULONG nd_apply(UINT op, ULONG inx, ULONG arg[4])
+
+{
+	ULONG rtn;
+
+	switch (op)
+	{
+	case ND_QSEND:
+		rtn = q_send (inx, arg);
+		break;
+
+	case ND_QURGENT:
+		rtn = q_urgent (inx, arg);
+		break;
+
+	case ND_SMV:
+		rtn = sm_v (inx);
+		break;
+
+	case ND_EVSEND:
+		rtn = ev_send (inx, arg[0]);
+		break;
+
+	default:
+		rtn = ERR_OBJTYPE;
+		break;
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				nd_ask
+*
+* Type:				Function
+*
+* Description:		ask other nodes for a global object
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static ULONG nd_ask(UINT cls, char name[4], ULONG node, ULONG *id)
+
+{
+	ULONG rtn;
+	ULONG pname;
+	ULONG mask;
+	ULONG inx;
+	UINT self;
+	NDASK *ask;
+	NDPACKET pkt;
+
+	rtn = ERR_OBJNF;
+	mask = 0;
+
+	pname = nd_name (name);
+	self = gxk_t_self ();
+
+	gxk_k_lock ();
+
+	if ((inx = nd_lookup (cls, pname, node)) < NODE_CACHE)
+	{
+		*id = NodeCache[inx].id;
+		rtn = 0;
+	}
+	else if (self < MAX_TASK)
+	{
+		ask = &NodeAsk[self];
+
+		for (inx = 1; inx <= NodeCfg.nnodes; inx++)
+		{
+			if ((inx != NodeNum) && (NodeUp[inx]) && ((node == 0) || (node == inx)))
+			{
+				mask |= (1UL << inx);
+			}
+		}
+
+		ask->busy = TRUE;
+		ask->seq++;
+		ask->asked = 0;
+		ask->replies = 0;
+		ask->code = ERR_OBJNF;
+
+		for (inx = 1; inx <= NodeCfg.nnodes; inx++)
+		{
+			if (mask & (1UL << inx)) ask->asked++;
+		}
+
+		pkt.op = ND_IDENT;
+		pkt.id = 0;
+		pkt.arg[0] = cls;
+		pkt.arg[1] = pname;
+		pkt.arg[2] = self;
+		pkt.arg[3] = ask->seq;
+	}
+
+	gxk_k_leave ();
+
+	if (mask != 0)
+	{
+		/*
+		 * the first node that has it answers the ask; it fails once
+		 * every node asked has said no, or after NODE_TMO
+		 */
+
+		for (inx = 1; inx <= NodeCfg.nnodes; inx++)
+		{
+			if (mask & (1UL << inx))
+			{
+				nd_put (inx, &pkt, TRUE);
+			}
+		}
+
+		gxk_k_lock ();
+
+		if ((ask->code != 0) && (ask->replies < ask->asked))
+		{
+			gxk_t_wait (NULL, NODE_TMO);
+		}
+
+		if ((rtn = ask->code) == 0)
+		{
+			*id = ask->id;
+
+			nd_remember (cls, pname, ask->id);
+		}
+
+		ask->busy = FALSE;
+
+		gxk_k_unlock ();
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				nd_take
+*
+* Type:				Function
+*
+* Description:		act on one packet of a frame received
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void nd_take(ULONG from, NDPACKET *pkt)
+
+{
+	UINT inx;
+	UINT was;
+	NDASK *ask;
+	NDNAME *nm;
+	NDPACKET reply;
+
+	switch (pkt->op)
+	{
+	case ND_QSEND:
+	case ND_QURGENT:
+	case ND_SMV:
+	case ND_EVSEND:
+		nd_apply ((UINT)pkt->op, pkt->id, pkt->arg);
+		break;
+
+	case ND_IDENT:
+		reply.op = ND_REPLY;
+		reply.id = 0;
+		reply.arg[0] = ERR_OBJNF;
+		reply.arg[1] = 0;
+		reply.arg[2] = pkt->arg[2];
+		reply.arg[3] = pkt->arg[3];
+
+		gxk_k_lock ();
+
+		for (inx = 0; inx < ND_EXPORTS; inx++)
+		{
+			nm = &NodeExport[inx];
+
+			if ((nm->state == ND_LIVE) && (nm->cls == pkt->arg[0]) && (nm->name == pkt->arg[1]))
+			{
+				reply.id = ND_ID (NodeNum, nm->id);
+				reply.arg[0] = 0;
+				break;
+			}
+		}
+
+		gxk_k_leave ();
+
+		nd_put (from, &reply, TRUE);
+		break;
+
+	case ND_REPLY:
+		if (pkt->arg[2] < MAX_TASK)
+		{
+			gxk_k_lock ();
+
+			ask = &NodeAsk[pkt->arg[2]];
+
+			if ((ask->busy) && (ask->seq == pkt->arg[3]) && (ask->code != 0))
+			{
+				if (pkt->arg[0] == 0)
+				{
+					ask->id = pkt->id;
+					ask->code = 0;
+
+					gxk_t_ready ((UINT)pkt->arg[2], 0);
+				}
+				else if (++ask->replies == ask->asked)
+				{
+					gxk_t_ready ((UINT)pkt->arg[2], 0);
+				}
+			}
+
+			gxk_k_unlock ();
+		}
+		break;
+
+	case ND_FORGET:
+		gxk_k_lock ();
+		nd_forget (from, (UINT)pkt->arg[0], pkt->arg[1]);
+		gxk_k_leave ();
+		break;
+
+	case ND_JOIN:
+	case ND_HELLO:
+		gxk_k_lock ();
+
+		was = NodeUp[from];
+		NodeUp[from] = TRUE;
+
+		/* a node joining again may have lost its objects */
+		nd_forget (from, 0, 0);
+
+		gxk_k_leave ();
+
+		if (pkt->op == ND_JOIN)
+		{
+			reply.op = ND_HELLO;
+			reply.id = 0;
+
+			nd_put (from, &reply, TRUE);
+		}
+
+		if (!was)
+		{
+			nd_roster (from, RSTR_JOIN);
+		}
+		break;
+
+	case ND_EXIT:
+		gxk_k_lock ();
+
+		was = NodeUp[from];
+		NodeUp[from] = FALSE;
+		nd_forget (from, 0, 0);
+
+		gxk_k_leave ();
+
+		if (was)
+		{
+			nd_roster (from, RSTR_EXIT);
+		}
+		break;
+
+	case ND_TERM:
+		k_terminate (NodeNum, pkt->arg[0], 0);
+		break;
+
+	default:
+		break;
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				k_join
+*
+* Type:				Function
+*
+* Description:		join this kernel to a multi-processor system
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG k_join(struct mpcfg *cfg)
+
+{
+	ULONG rtn;
+	ULONG inx;
+	NDPACKET pkt;
+
+	rtn = 0;
+
+	if ((cfg->nnodes > MAX_NODE) || (cfg->node == 0) || (cfg->node > cfg->nnodes) ||
+		(cfg->ki_send == NULL) || (NodeNum != 0))
+	{
+		rtn = ERR_NODENO;
+	}
+	else
+	{
+		gxk_k_lock ();
+
+		NodeCfg = *cfg;
+
+		for (inx = 0; inx <= MAX_NODE; inx++)
+		{
+			NodeUp[inx] = FALSE;
+		}
+
+		for (inx = 0; inx < NODE_CACHE; inx++)
+		{
+			NodeCache[inx].state = ND_FREE;
+		}
+
+		NodeNum = cfg->node;
+
+		gxk_k_leave ();
+
+		nd_roster (NodeNum, RSTR_NEW);
+
+		/*
+		 * the nodes already in answer with ND_HELLO
+		 */
+
+		pkt.op = ND_JOIN;
+		pkt.id = 0;
+
+		for (inx = 1; inx <= NodeCfg.nnodes; inx++)
+		{
+			if (inx != NodeNum)
+			{
+				nd_put (inx, &pkt, TRUE);
+			}
+		}
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				k_receive
+*
+* Type:				Function
+*
+* Description:		act on a frame the transport received for this node
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG k_receive(void *frame, ULONG len)
+
+{
+	ULONG rtn;
+	ULONG inx;
+	NDFRAME *fr;
+
+	rtn = 0;
+	fr = (NDFRAME *)frame;
+
+	/*
+	 * called by the transport from a thread of its own, not at
+	 * interrupt level: the calls in the frame may enter the kernel
+	 */
+
+	if ((len < ND_FRAMELEN (0)) || (fr->count > NODE_BATCH) || (len < ND_FRAMELEN (fr->count)))
+	{
+		rtn = ERR_KISIZE;
+	}
+	else if ((NodeNum == 0) || (fr->from == 0) || (fr->from > NodeCfg.nnodes) || (fr->from == NodeNum))
+	{
+		rtn = ERR_NODENO;
+	}
+	else
+	{
+		for (inx = 0; inx < fr->count; inx++)
+		{
+			nd_take (fr->from, &fr->pkt[inx]);
+		}
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				k_terminate
+*
+* Type:				Function
+*
+* Description:		take a node out of the system
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG k_terminate(ULONG node, ULONG fcode, ULONG flags)
+
+{
+	ULONG rtn;
+	ULONG inx;
+	NDPACKET pkt;
+
+	rtn = 0;
+
+	/* no termination flags are defined */
+	(void)flags;
+
+	if ((NodeNum == 0) || (node == 0) || (node > NodeCfg.nnodes))
+	{
+		rtn = ERR_NODENO;
+	}
+	else if (node != NodeNum)
+	{
+		pkt.op = ND_TERM;
+		pkt.id = 0;
+		pkt.arg[0] = fcode;
+
+		nd_put (node, &pkt, TRUE);
+	}
+	else
+	{
+		/*
+		 * calls still batched go first; the node's own objects stay,
+		 * reachable again after another k_join
+		 */
+
+		gxk_nd_flush ();
+
+		pkt.op = ND_EXIT;
+		pkt.id = 0;
+
+		for (inx = 1; inx <= NodeCfg.nnodes; inx++)
+		{
+			if ((inx != NodeNum) && (NodeUp[inx]))
+			{
+				nd_put (inx, &pkt, TRUE);
+			}
+		}
+
+		gxk_k_lock ();
+
+		for (inx = 0; inx <= MAX_NODE; inx++)
+		{
+			NodeUp[inx] = FALSE;
+		}
+
+		for (inx = 0; inx < ND_EXPORTS; inx++)
+		{
+			if (NodeExport[inx].state == ND_GONE)
+			{
+				NodeExport[inx].state = ND_FREE;
+			}
+		}
+
+		NodeNum = 0;
+
+		gxk_k_leave ();
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_nd_send
+*
+* Type:				Function
+*
+* Description:		make a call on a remote object
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_nd_send(UINT op, ULONG id, ULONG arg[4])
+
+{
+	ULONG rtn;
+	ULONG node;
+	NDPACKET pkt;
+
+	rtn = 0;
+	node = ND_NODE (id);
+
+	if (NodeNum == 0)
+	{
+		/* the id cannot be valid */
+		rtn = ERR_OBJID;
+	}
+	else if (node > NodeCfg.nnodes)
+	{
+		rtn = ERR_NODENO;
+	}
+	else if (node == NodeNum)
+	{
+		rtn = nd_apply (op, ND_INDEX (id), arg);
+	}
+	else if (!NodeUp[node])
+	{
+		rtn = ERR_NDKLD;
+	}
+	else
+	{
+		pkt.op = op;
+		pkt.id = ND_INDEX (id);
+
+		if (arg != NULL)
+		{
+			pkt.arg[0] = arg[0];
+			pkt.arg[1] = arg[1];
+			pkt.arg[2] = arg[2];
+			pkt.arg[3] = arg[3];
+		}
+
+		nd_put (node, &pkt, FALSE);
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_nd_ident
+*
+* Type:				Function
+*
+* Description:		find an object by name, asking other nodes for a global one
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_nd_ident(UINT cls, char name[4], ULONG node, ULONG *id)
+
+{
+	ULONG rtn;
+
+	rtn = ERR_OBJNF;
+
+	/*
+	 * node 0 looks here first, then at the global objects of every
+	 * node; a node not joined has only itself and ignores the node
+	 */
+
+	if ((NodeNum == 0) || (node == 0) || (node == NodeNum))
+	{
+		gxk_k_lock ();
+		rtn = gxk_nm_find (cls, name, id);
+		gxk_k_leave ();
+	}
+
+	if ((rtn != 0) && (NodeNum != 0) && (node != NodeNum))
+	{
+		rtn = (node > NodeCfg.nnodes) ? ERR_NODENO : nd_ask (cls, name, node, id);
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_nd_export
+*
+* Type:				Function
+*
+* Description:		make an object created global identifiable from other nodes
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_nd_export(UINT cls, char name[4], ULONG id)
+
+{
+	UINT inx;
+	NDNAME *nm;
+
+	/*
+	 * called with the kernel locked; there is an entry for every
+	 * object, so the table cannot fill
+	 */
+
+	for (inx = 0; inx < ND_EXPORTS; inx++)
+	{
+		nm = &NodeExport[inx];
+
+		if (nm->state == ND_FREE)
+		{
+			nm->state = ND_LIVE;
+			nm->cls = cls;
+			nm->name = nd_name (name);
+			nm->id = id;
+			break;
+		}
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_nd_unexport
+*
+* Type:				Function
+*
+* Description:		withdraw a global object being deleted
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_nd_unexport(UINT cls, ULONG id)
+
+{
+	UINT inx;
+	NDNAME *nm;
+
+	/*
+	 * called with the kernel locked; the other nodes are told on the
+	 * next gxk_nd_flush to drop what they cached of it
+	 */
+
+	for (inx = 0; inx < ND_EXPORTS; inx++)
+	{
+		nm = &NodeExport[inx];
+
+		if ((nm->state == ND_LIVE) && (nm->cls == cls) && (nm->id == id))
+		{
+			if (NodeNum != 0)
+			{
+				nm->state = ND_GONE;
+
+				gxk_tm_batch ();
+			}
+			else
+			{
+				nm->state = ND_FREE;
+			}
+			break;
+		}
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_nd_flush
+*
+* Type:				Function
+*
+* Description:		send frames left part full, with the withdrawals pending
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_nd_flush(void)
+
+{
+	UINT inx;
+	ULONG node;
+	NDLINK *ln;
+	NDPACKET pkt;
+
+	/*
+	 * called with the kernel unlocked, on every clock tick
+	 */
+
+	if (NodeNum == 0)
+	{
+		return;
+	}
+
+	pkt.op = ND_FORGET;
+	pkt.id = 0;
+
+	for (inx = 0; inx < ND_EXPORTS; inx++)
+	{
+		if (NodeExport[inx].state == ND_GONE)
+		{
+			gxk_k_lock ();
+
+			pkt.arg[0] = NodeExport[inx].cls;
+			pkt.arg[1] = NodeExport[inx].name;
+			NodeExport[inx].state = ND_FREE;
+
+			gxk_k_leave ();
+
+			for (node = 1; node <= NodeCfg.nnodes; node++)
+			{
+				if ((node != NodeNum) && (NodeUp[node]))
+				{
+					nd_put (node, &pkt, FALSE);
+				}
+			}
+		}
+	}
+
+	for (node = 1; node <= NodeCfg.nnodes; node++)
+	{
+		ln = &NodeLink[node];
+
+		if (ln->out.count != 0)
+		{
+			gxk_h_lock (&ln->lock);
+
+			if (ln->out.count != 0)
+			{
+				ln->out.from = NodeNum;
+
+				NodeCfg.ki_send (node, &ln->out, ND_FRAMELEN (ln->out.count));
+
+				ln->out.count = 0;
+			}
+
+			gxk_h_unlock (&ln->lock);
+		}
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_nd_init
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_nd_init(void)
+
+{
+	UINT inx;
+
+	NodeNum = 0;
+	CacheNext = 0;
+
+	for (inx = 0; inx <= MAX_NODE; inx++)
+	{
+		NodeUp[inx] = FALSE;
+		NodeLink[inx].out.count = 0;
+		gxk_h_lockinit (&NodeLink[inx].lock);
+	}
+
+	for (inx = 0; inx < NODE_CACHE; inx++)
+	{
+		NodeCache[inx].state = ND_FREE;
+	}
+
+	for (inx = 0; inx < ND_EXPORTS; inx++)
+	{
+		NodeExport[inx].state = ND_FREE;
+	}
+
+	for (inx = 0; inx < MAX_TASK; inx++)
+	{
+		NodeAsk[inx].busy = FALSE;
+		NodeAsk[inx].seq = 0;
+	}
+
+	return (0);
+}
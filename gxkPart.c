@@ -0,0 +1,754 @@
+/************************************BEGIN*****************************************
+*                       COPYRIGHT %G% %U% BY GHWORKS, LLC 
+*                             ALL RIGHTS RESERVED
+*                         SPDX-License-Identifier: MIT
+* ********************************************************************************
+* Name:        gxkPart
+* Type:        C Source
+* File:        %M%
+* Version:     %I%
+* Description: Partition Services Interface
+*
+* Interface (public) Routines:
+*
+*	pt_create
+*	pt_delete
+*	pt_getbuf
+*	pt_ident
+*	pt_retbuf
+*	pt_sgetbuf
+*
+*	gxk_pt_init
+*	gxk_pt_purge
+*
+* Private Functions:
+*
+*	pool_pop
+*	pool_push
+*	pt_carve
+*
+* Modification History:
+* ----------------------------------------------------------- 
+* Date		Initials		Change Description
+* -----------------------------------------------------------
+* 10/14/26	GVH				Created
+*
+**************************************END***************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "gxkHost.h"
+#include "gxkernel.h"
+#include "gxkCfg.h"
+#include "gxkSys.h"
+
+/********************************
+		LOCAL DECLARATIONS
+********************************/
+
+/*
+ * the caller's memory holds an allocation bitmap followed by the
+ * blocks, the first aligned to the smaller of the block size and a
+ * cache line.  free blocks are chained through their first word and
+ * the chain head is one 64 bit word, a reuse tag over the block
+ * index, swapped by compare exchange so a stale head from an ABA
+ * interleaving never matches.  the bitmap catches double returns.
+ *
+ * partitions created with PT_MAG also keep a small per-task cache of
+ * free blocks; get and return work out of it without touching the
+ * shared chain until it runs dry or full.  a cache is only touched
+ * by its owner, so buffers cached by one task are not seen by another
+ */
+
+#define NO_BLK				0xFFFFFFFF				/* end of the free chain */
+#define MAP_BITS			(8 * sizeof (LONG))
+#define MAP_WORDS(n)		(((n) + MAP_BITS - 1) / MAP_BITS)
+
+#define BLK_ADDR(pt, blk)	((pt)->base + ((DWORD_PTR)(blk) << (pt)->shift))
+#define BLK_LINK(pt, blk)	(*(volatile ULONG *)BLK_ADDR (pt, blk))
+
+typedef struct
+{
+	UINT count;
+	ULONG blk[PT_MAGSIZE];
+} PTMAG;
+
+typedef struct
+{
+	char name[4];
+	ULONG flags;
+	char *base;						/* first block */
+	ULONG bsize;
+	UINT shift;						/* log2 bsize */
+	ULONG nbuf;
+	volatile LONG *map;				/* bit set = block allocated */
+	volatile LONGLONG head;			/* tag:32 block:32 */
+} PTDESC;
+
+/********************************
+		GLOBALS
+********************************/
+
+PTDESC PtTbl[MAX_PART];
+PTMAG PtMag[MAX_PART][MAX_TASK];
+
+/******************************************************************************
+*						  
+* Name:				pool_pop
+*
+* Type:				Function
+*
+* Description:		take a block off the shared free chain
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static ULONG pool_pop(PTDESC *pt)
+
+{
+	LONGLONG head;
+	ULONG blk;
+	ULONGLONG next;
+
+	for (;;)
+	{
+		head = pt->head;
+		blk = (ULONG)(head & 0xFFFFFFFF);
+
+		if (blk == NO_BLK) break;
+
+		/*
+		 * the link is stale if the block was taken and returned in
+		 * between; its tag has then moved on and the exchange fails
+		 */
+
+		next = ((((ULONGLONG)head >> 32) + 1) << 32) | BLK_LINK (pt, blk);
+
+		if (InterlockedCompareExchange64 (&pt->head, (LONGLONG)next, head) == head) break;
+	}
+
+	return (blk);
+}
+
+/******************************************************************************
+*						  
+* Name:				pool_push
+*
+* Type:				Function
+*
+* Description:		put a block back on the shared free chain
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void pool_push(PTDESC *pt, ULONG blk)
+
+{
+	LONGLONG head;
+	ULONGLONG next;
+
+	for (;;)
+	{
+		head = pt->head;
+
+		BLK_LINK (pt, blk) = (ULONG)(head & 0xFFFFFFFF);
+
+		next = ((((ULONGLONG)head >> 32) + 1) << 32) | blk;
+
+		if (InterlockedCompareExchange64 (&pt->head, (LONGLONG)next, head) == head) break;
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				pt_carve
+*
+* Type:				Function
+*
+* Description:		lay out the bitmap and blocks in the partition memory
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static ULONG pt_carve(char *laddr, ULONG length, ULONG bsize, char **base)
+
+{
+	ULONG align;
+	ULONG nbuf;
+	DWORD_PTR start;
+	DWORD_PTR end;
+
+	align = (bsize < CACHE_LINE) ? bsize : CACHE_LINE;
+	end = (DWORD_PTR)laddr + length;
+
+	/*
+	 * each block costs bsize bytes plus one bitmap bit; start from
+	 * that bound and give back what word rounding and alignment take
+	 */
+
+	nbuf = ((length / ((8 * bsize) + 1)) * 8) + (((length % ((8 * bsize) + 1)) * 8) / ((8 * bsize) + 1));
+
+	for (; nbuf > 0; nbuf--)
+	{
+		start = ((DWORD_PTR)laddr + (MAP_WORDS (nbuf) * sizeof (LONG)) + align - 1) & ~(DWORD_PTR)(align - 1);
+
+		if ((start <= end) && (((end - start) / bsize) >= nbuf))
+		{
+			*base = (char *)start;
+			break;
+		}
+	}
+
+	return (nbuf);
+}
+
+/******************************************************************************
+*						  
+* Name:				pt_create
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG pt_create(char name[4], void *paddr, void *laddr, ULONG length,
+				ULONG bsize, ULONG flags, ULONG *ptid, ULONG *nbuf)
+
+{
+	ULONG rtn;
+	ULONG inx;
+	ULONG blk;
+	ULONG cnt;
+	UINT shift;
+	char *base;
+	PTDESC *pt;
+
+	rtn = 0;
+	cnt = 0;
+
+	/* one address space, so the buffers are used at laddr */
+	(void)paddr;
+
+	*ptid = MAX_PART;
+
+	for (shift = 0; ((1UL << shift) < bsize) && (shift < 31); shift++)
+	{
+	}
+
+	if (((DWORD_PTR)laddr & (sizeof (ULONG) - 1)) != 0)
+	{
+		rtn = ERR_PTADDR;
+	}
+	else if ((bsize < sizeof (ULONG)) || ((1UL << shift) != bsize))
+	{
+		rtn = ERR_BUFSIZE;
+	}
+	else if ((cnt = pt_carve ((char *)laddr, length, bsize, &base)) == 0)
+	{
+		rtn = ERR_TINYPT;
+	}
+	else
+	{
+		gxk_k_lock ();
+
+		for (inx = 0; inx < MAX_PART; inx++)
+		{
+			if (PtTbl[inx].name[0] == '\0') break;
+		}
+
+		if (inx == MAX_PART)
+		{
+			rtn = ERR_OBJTFULL;
+		}
+		else
+		{
+			pt = &PtTbl[inx];
+
+			*ptid = inx;
+
+			pt->name[0] = name[0];
+			pt->name[1] = name[1];
+			pt->name[2] = name[2];
+			pt->name[3] = name[3];
+
+			gxk_nm_add (NM_PART, pt->name, inx);
+
+			pt->flags = flags;
+			pt->base = base;
+			pt->bsize = bsize;
+			pt->shift = shift;
+			pt->nbuf = cnt;
+			pt->map = (volatile LONG *)laddr;
+
+			for (blk = 0; blk < MAP_WORDS (cnt); blk++)
+			{
+				pt->map[blk] = 0;
+			}
+
+			/*
+			 * chain the blocks in address order
+			 */
+
+			for (blk = 0; blk < cnt; blk++)
+			{
+				BLK_LINK (pt, blk) = ((blk + 1) < cnt) ? (blk + 1) : NO_BLK;
+			}
+
+			pt->head = 0;
+
+			for (blk = 0; blk < MAX_TASK; blk++)
+			{
+				PtMag[inx][blk].count = 0;
+			}
+		}
+
+		gxk_k_leave ();
+	}
+
+	*nbuf = (rtn == 0) ? cnt : 0;
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				pt_delete
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG pt_delete(ULONG ptid)
+
+{
+	ULONG rtn;
+	ULONG inx;
+	PTDESC *pt;
+
+	rtn = 0;
+
+	if (ptid < MAX_PART)
+	{
+		gxk_k_lock ();
+
+		pt = &PtTbl[ptid];
+
+		if (pt->name[0] == '\0')
+		{
+			rtn = ERR_OBJID;
+		}
+		else
+		{
+			if ((pt->flags & PT_DEL) == 0)
+			{
+				for (inx = 0; inx < MAP_WORDS (pt->nbuf); inx++)
+				{
+					if (pt->map[inx] != 0)
+					{
+						rtn = ERR_BUFINUSE;
+						break;
+					}
+				}
+			}
+
+			if (rtn == 0)
+			{
+				gxk_nm_remove (NM_PART, pt->name, ptid);
+
+				pt->name[0] = '\0';
+			}
+		}
+
+		gxk_k_leave ();
+	}
+	else
+	{
+		rtn = ERR_OBJID;
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				pt_getbuf
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG pt_getbuf(ULONG ptid, void **bufaddr)
+
+{
+	ULONG rtn;
+	ULONG blk;
+	UINT self;
+	PTDESC *pt;
+	PTMAG *mag;
+
+	rtn = 0;
+
+	if ((ptid >= MAX_PART) || (PtTbl[ptid].name[0] == '\0'))
+	{
+		return (ERR_OBJID);
+	}
+
+	pt = &PtTbl[ptid];
+	mag = NULL;
+
+	if (pt->flags & PT_MAG)
+	{
+		if ((self = gxk_t_self ()) < MAX_TASK)
+		{
+			mag = &PtMag[ptid][self];
+		}
+	}
+
+	if ((mag != NULL) && (mag->count != 0))
+	{
+		blk = mag->blk[--mag->count];
+	}
+	else
+	{
+		blk = pool_pop (pt);
+	}
+
+	if (blk == NO_BLK)
+	{
+		*bufaddr = NULL;
+		rtn = ERR_NOBUF;
+	}
+	else
+	{
+		InterlockedOr (&pt->map[blk / MAP_BITS], (LONG)(1UL << (blk % MAP_BITS)));
+
+		*bufaddr = BLK_ADDR (pt, blk);
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				pt_ident
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG pt_ident(char name[4], ULONG node, ULONG *ptid)
+
+{
+	ULONG rtn;
+
+	/* partitions are never global, so only this node is searched */
+	(void)node;
+
+	gxk_k_lock ();
+	rtn = gxk_nm_find (NM_PART, name, ptid);
+	gxk_k_leave ();
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				pt_retbuf
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG pt_retbuf(ULONG ptid, void *buf_addr)
+
+{
+	ULONG rtn;
+	ULONG blk;
+	LONG bit;
+	DWORD_PTR off;
+	UINT self;
+	PTDESC *pt;
+	PTMAG *mag;
+
+	rtn = 0;
+
+	if ((ptid >= MAX_PART) || (PtTbl[ptid].name[0] == '\0'))
+	{
+		return (ERR_OBJID);
+	}
+
+	pt = &PtTbl[ptid];
+	off = (DWORD_PTR)buf_addr - (DWORD_PTR)pt->base;
+
+	if (((char *)buf_addr < pt->base) || ((off >> pt->shift) >= pt->nbuf) || ((off & (pt->bsize - 1)) != 0))
+	{
+		rtn = ERR_BUFADDR;
+	}
+	else
+	{
+		blk = (ULONG)(off >> pt->shift);
+		bit = (LONG)(1UL << (blk % MAP_BITS));
+
+		if ((InterlockedAnd (&pt->map[blk / MAP_BITS], ~bit) & bit) == 0)
+		{
+			rtn = ERR_BUFFREE;
+		}
+		else
+		{
+			mag = NULL;
+
+			if (pt->flags & PT_MAG)
+			{
+				if ((self = gxk_t_self ()) < MAX_TASK)
+				{
+					mag = &PtMag[ptid][self];
+				}
+			}
+
+			if (mag == NULL)
+			{
+				pool_push (pt, blk);
+			}
+			else
+			{
+				/*
+				 * a full cache spills half, so a task alternating
+				 * around the boundary does not hit the chain each time
+				 */
+
+				if (mag->count == PT_MAGSIZE)
+				{
+					while (mag->count > (PT_MAGSIZE / 2))
+					{
+						pool_push (pt, mag->blk[--mag->count]);
+					}
+				}
+
+				mag->blk[mag->count++] = blk;
+			}
+		}
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				pt_sgetbuf
+*
+* Type:				Function
+*
+* Description:		get a buffer and its physical address, the same without an MMU
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG pt_sgetbuf(ULONG ptid, void **paddr, void **laddr)
+
+{
+	ULONG rtn;
+
+	rtn = pt_getbuf (ptid, laddr);
+
+	*paddr = *laddr;
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_pt_init
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_pt_init(void)
+
+{
+	UINT inx;
+
+	for (inx = 0; inx < MAX_PART; inx++)
+	{
+		PtTbl[inx].name[0] = '\0';
+		PtTbl[inx].nbuf = 0;
+		PtTbl[inx].head = NO_BLK;
+	}
+
+	return (0);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_pt_purge
+*
+* Type:				Function
+*
+* Description:		return the buffers a task has cached to their partitions
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_pt_purge(ULONG tid)
+
+{
+	UINT inx;
+	PTMAG *mag;
+
+	/*
+	 * called with the kernel locked from task deletion and restart
+	 */
+
+	for (inx = 0; inx < MAX_PART; inx++)
+	{
+		mag = &PtMag[inx][tid];
+
+		if (PtTbl[inx].name[0] != '\0')
+		{
+			while (mag->count != 0)
+			{
+				pool_push (&PtTbl[inx], mag->blk[--mag->count]);
+			}
+		}
+
+		mag->count = 0;
+	}
+}
@@ -11,22 +11,63 @@
 *
 * Interface (public) Routines:
 *
+*	q_asend
+*	q_aurgent
+*	q_avsend
 *	q_broadcast
 *	q_create
 *	q_delete
 *	q_ident
+*	q_info
 *	q_receive
+*	q_receive_n
 *	q_send
+*	q_send_n
 *	q_urgent
+*	q_vborrow
+*	q_vcommit
 *	q_vcreate
 *	q_vdelete
 *	q_vident
 *	q_vreceive
+*	q_vrelease
+*	q_vreserve
 *	q_vsend
 *
+*	gxk_q_fetch
+*	gxk_q_push
+*	gxk_q_select
+*	gxk_q_wake
+*
 * Private Functions:
 *
+*	buf_alloc
+*	buf_free
+*	buf_link
+*	buf_unlink
 *	gxk_q_init
+*	q_claim
+*	q_commit
+*	q_count
+*	q_drop
+*	q_kill
+*	q_fetch
+*	q_hold
+*	q_put
+*	q_reclaim
+*	q_room
+*	q_slot
+*	q_take
+*	q_wait
+*	q_vput
+*	q_wake
+*	ring_claim
+*	ring_empty
+*	ring_get
+*	ring_put
+*	ring_seq
+*	urg_get
+*	vslot
 *
 * Modification History:
 * ----------------------------------------------------------- 
@@ -37,54 +78,141 @@
 **************************************END***************************************/
 
 #include <stdio.h>
-#include <windows.h>
 #include <stdlib.h>
-#include <process.h>
+#include "gxkHost.h"
+#include <string.h>
 #include "gxkernel.h"
 #include "gxkCfg.h"
+#include "gxkSys.h"
 
 /********************************
 		LOCAL DECLARATIONS
 ********************************/
 
+/*
+ * each queue owns a power of two run of Buf used as a bounded ring;
+ * a slot's sequence number says whose turn it is: equal to the
+ * enqueue position when free, one past it once the message is in.
+ * senders and receivers claim positions with a compare-exchange
+ * on nextin / nextout, so the ring itself needs no lock.
+ *
+ * variable length queues run the same ring over a private array of
+ * maxlen byte slots, each led by a VMSGHDR.
+ *
+ * q_urgent messages bypass the ring: they are stacked under the
+ * kernel lock and received ahead of it, newest first.  the stack is
+ * a second Buf block the size of the ring, taken at the first urgent
+ * message, and what it holds counts against the ring, so a queue
+ * never holds more than its ring size.  a q_aurgent message claims
+ * its place when it is posted and is stacked when the kernel runs
+ * the deferred work, so it is stacked after urgent messages sent
+ * since but is never refused once the post has returned 0
+ */
+
+/*
+ * q_broadcast copies straight into the buffer each blocked receiver
+ * left in RecvBuf and wakes it with Q_HANDOFF
+ */
+
+#define Q_HANDOFF			0x80000000		/* wake code: message delivered */
+
 typedef struct
 {
+	volatile LONG seq;			/* ring turn of this slot */
 	ULONG msg[4];
+	ULONG pad[3];				/* two slots per cache line */
 } MSGBUF;
 
+typedef struct
+{
+	volatile LONG seq;			/* ring turn of this slot */
+	ULONG pos;					/* position it was claimed for */
+	ULONG len;					/* message length */
+} VMSGHDR;
+
 typedef struct
 {
 	ULONG start;
-	ULONG end;
-	ULONG nextin;
-	ULONG nextout;
+	ULONG order;				/* Buf block is 2^order slots */
+	ULONG ustart;				/* urgent stack block, NO_BUF until used */
+	ULONG mask;					/* ring size - 1 */
+	char *vbuf;					/* variable length slots */
+	ULONG stride;				/* bytes per variable slot */
+	CACHE_ALIGN volatile LONG nextin;	/* next enqueue position */
+	CACHE_ALIGN volatile LONG nextout;	/* next dequeue position */
 } QBUFDESC;
 
+/*
+ * statistics for q_info are bumped with interlocked adds, what
+ * senders and receivers count on separate lines.  peak is the most
+ * messages seen waiting just after a send
+ */
+
 typedef struct
 {
-	char name[4];
-	ULONG count;
+	CACHE_ALIGN volatile LONG sent;
+	volatile LONG drops;		/* messages refused with ERR_QFULL */
+	volatile LONG peak;
+	CACHE_ALIGN volatile LONG received;
+} QSTATS;
+
+/*
+ * what every send and receive reads comes first, then the ring with
+ * the sender and receiver cursors on lines of their own and the
+ * statistics
+ */
+
+typedef struct
+{
+	CACHE_ALIGN char name[4];
+	UINT var;					/* variable length queue */
 	ULONG flags;
-	char semname[4];
-	ULONG semid;
+	ULONG count;
+	ULONG maxlen;				/* largest variable message */
+	volatile LONG waiters;		/* receivers about to block or blocked */
+	volatile LONG users;		/* callers on the ring outside the kernel lock */
+	ULONG selectors;			/* of those, tasks in sl_wait */
+	volatile LONG nurg;			/* urgent messages stacked */
+	volatile LONG nclaim;		/* urgent places claimed: stacked or posted */
+	GXKWAITQ waitq;				/* tasks blocked in q_receive */
 	QBUFDESC buf;
+	QSTATS stats;
 } QDESC;
 
+/*
+ * ring storage is handed out of Buf by a binary buddy allocator; a
+ * block of 2^order slots is free when BufTag at its first slot is
+ * order + 1, and sits on the doubly linked list FreeHead[order]
+ */
+
+#define BUF_ORDERS			12				/* 2^(BUF_ORDERS - 1) == MAX_BUF */
+#define NO_BUF				MAX_BUF
+
+#if ((1 << (BUF_ORDERS - 1)) != MAX_BUF)
+#error MAX_BUF must be 2^(BUF_ORDERS - 1)
+#endif
+
 /********************************
 		GLOBALS
 ********************************/
 
 QDESC QTbl[MAX_Q];
-MSGBUF Buf[MAX_BUF];
-ULONG NextAvailBuf;
+CACHE_ALIGN MSGBUF Buf[MAX_BUF];
+
+ULONG *RecvBuf[MAX_TASK];
+
+ULONG FreeHead[BUF_ORDERS];
+ULONG BufNext[MAX_BUF];
+ULONG BufPrev[MAX_BUF];
+UCHAR BufTag[MAX_BUF];
 
 /******************************************************************************
 *						  
-* Name:				q_broadcast
+* Name:				buf_link
 *
 * Type:				Function
 *
-* Description:		
+* Description:		put a free block on its order's list
 * 
 * Formal Inputs:	
 *
@@ -99,20 +227,29 @@ ULONG NextAvailBuf;
 * Author:			GVH
 *
 ******************************************************************************/
-		  
-ULONG q_broadcast(ULONG qid, ULONG msg_buf[4], ULONG *count)
+
+static void buf_link(ULONG blk, ULONG order)
 
 {
-	return (0);
+	BufTag[blk] = (UCHAR)(order + 1);
+	BufPrev[blk] = NO_BUF;
+	BufNext[blk] = FreeHead[order];
+
+	if (FreeHead[order] != NO_BUF)
+	{
+		BufPrev[FreeHead[order]] = blk;
+	}
+
+	FreeHead[order] = blk;
 }
 
 /******************************************************************************
 *						  
-* Name:				q_create
+* Name:				buf_unlink
 *
 * Type:				Function
 *
-* Description:		
+* Description:		take a free block off its order's list
 * 
 * Formal Inputs:	
 *
@@ -128,70 +265,33 @@ ULONG q_broadcast(ULONG qid, ULONG msg_buf[4], ULONG *count)
 *
 ******************************************************************************/
 
-ULONG q_create(char name[4], ULONG count, ULONG flags, ULONG *qid)
+static void buf_unlink(ULONG blk, ULONG order)
 
 {
-	ULONG rtn;
-	ULONG inx;
-	QDESC *q;
-
-	rtn = 0;
-
-	for (inx = 0, *qid = MAX_Q; inx < MAX_Q; inx++)
+	if (BufPrev[blk] != NO_BUF)
 	{
-		if (QTbl[inx].name[0] == '\0') break;
+		BufNext[BufPrev[blk]] = BufNext[blk];
 	}
-
-	if ((inx < MAX_Q) && (NextAvailBuf < MAX_BUF))
+	else
 	{
-		if (NextAvailBuf >= MAX_BUF)
-		{
-			rtn = ERR_NOMGB;
-		}
-		else
-		{
-			q = &QTbl[inx];
-
-			sprintf (q->semname, "qs%d",inx);
-
-			if (sm_create(q->semname, 0, (SM_LOCAL | SM_FIFO),&q->semid) == 0)
-			{
-				*qid = inx;
-
-				q->name[0] = name[0];
-				q->name[1] = name[1];
-				q->name[2] = name[2];
-				q->name[3] = name[3];
-
-				q->count = count;
-				q->flags = flags;
-
-				q->buf.start = q->buf.nextin = q->buf.nextout = NextAvailBuf;
-				q->buf.end = q->buf.start + count - 1;
-
-				NextAvailBuf += count;
-			}
-			else
-			{
-				rtn = ERR_NOQCB;
-			}
-		}
+		FreeHead[order] = BufNext[blk];
 	}
-	else
+
+	if (BufNext[blk] != NO_BUF)
 	{
-		rtn = ERR_NOQCB;
+		BufPrev[BufNext[blk]] = BufPrev[blk];
 	}
 
-	return (rtn);
+	BufTag[blk] = 0;
 }
 
 /******************************************************************************
 *						  
-* Name:				q_delete
+* Name:				buf_alloc
 *
 * Type:				Function
 *
-* Description:		
+* Description:		allocate 2^order ring slots from Buf
 * 
 * Formal Inputs:	
 *
@@ -207,46 +307,48 @@ ULONG q_create(char name[4], ULONG count, ULONG flags, ULONG *qid)
 *
 ******************************************************************************/
 
-ULONG q_delete(ULONG qid)
+static ULONG buf_alloc(ULONG order)
 
 {
-	ULONG rtn;
-
-	rtn = 0;
+	ULONG blk;
+	ULONG inx;
 
-	if (qid < MAX_Q)
-	{
-		if (QTbl[qid].name[0] != '\0')
-		{
-			QTbl[qid].name[0] = '\0';
+	/*
+	 * called with the kernel locked; take the smallest free block
+	 * that fits and split the unused halves back onto their lists
+	 */
 
-			if (sm_delete(QTbl[qid].semid) != 0)
-			{
-				printf ("\nUnable to delete queue semaphore");
-			}
+	blk = NO_BUF;
 
-			/* free queues buffers */
-		}
-		else
+	for (inx = order; inx < BUF_ORDERS; inx++)
+	{
+		if (FreeHead[inx] != NO_BUF)
 		{
-			rtn = ERR_OBJID;
+			blk = FreeHead[inx];
+			buf_unlink (blk, inx);
+			break;
 		}
 	}
-	else
+
+	if (blk != NO_BUF)
 	{
-		rtn = ERR_OBJID;
+		while (inx > order)
+		{
+			--inx;
+			buf_link (blk + (1UL << inx), inx);
+		}
 	}
 
-	return (rtn);
+	return (blk);
 }
 
 /******************************************************************************
 *						  
-* Name:				q_ident
+* Name:				buf_free
 *
 * Type:				Function
 *
-* Description:		
+* Description:		return 2^order ring slots to Buf
 * 
 * Formal Inputs:	
 *
@@ -262,37 +364,35 @@ ULONG q_delete(ULONG qid)
 *
 ******************************************************************************/
 
-ULONG q_ident(char name[4], ULONG node, ULONG *qid)
+static void buf_free(ULONG blk, ULONG order)
 
 {
-	ULONG rtn;
-	ULONG inx;
-
-	rtn = ERR_OBJNF;
+	ULONG buddy;
 
-	for (inx = 0; inx < MAX_Q; inx++)
+	/* coalesce with the buddy as long as it is free at the same order */
+	while (order < (BUF_ORDERS - 1))
 	{
-		if ((QTbl[inx].name[0] == name[0]) &&
-			(QTbl[inx].name[1] == name[1]) &&
-			(QTbl[inx].name[2] == name[2]) &&
-			(QTbl[inx].name[3] == name[3]))
-		{
-			*qid = inx;
-			rtn = 0;
-			break;
-		}
+		buddy = blk ^ (1UL << order);
+
+		if (BufTag[buddy] != (UCHAR)(order + 1)) break;
+
+		buf_unlink (buddy, order);
+
+		if (buddy < blk) blk = buddy;
+
+		++order;
 	}
 
-	return (rtn);
+	buf_link (blk, order);
 }
 
 /******************************************************************************
 *						  
-* Name:				q_receive
+* Name:				ring_seq
 *
 * Type:				Function
 *
-* Description:		
+* Description:		sequence word of the slot at a ring position
 * 
 * Formal Inputs:	
 *
@@ -307,71 +407,19 @@ ULONG q_ident(char name[4], ULONG node, ULONG *qid)
 * Author:			GVH
 *
 ******************************************************************************/
-
-ULONG q_receive(ULONG qid, ULONG flags, ULONG timeout, ULONG msg_buf[4])
+	
+static volatile LONG *ring_seq(QDESC *q, ULONG pos)
 
 {
-	ULONG rtn;
-	ULONG rtn1;
-	QDESC *q;
-	ULONG lflags;
-
-	rtn = 0;
+	volatile LONG *rtn;
 
-	if ((qid < MAX_Q) && (QTbl[qid].name[0] != '\0'))
+	if (q->var)
 	{
-		q = &QTbl[qid];
-
-		if (q->buf.nextout == q->buf.nextin)
-		{
-			/* no message available, wait for sender */
-			lflags = (flags & Q_NOWAIT) ? SM_NOWAIT : SM_WAIT;
-
-			rtn1 = sm_p (q->semid, lflags, timeout);
-			switch (rtn1)
-			{
-			case 0:
-				if (flags & Q_NOWAIT)
-				{
-					rtn = ERR_NOMSG;
-				}
-				else
-				{
-					/* message pending */
-					msg_buf[0] = Buf[q->buf.nextout].msg[0];
-					msg_buf[1] = Buf[q->buf.nextout].msg[1];
-					msg_buf[2] = Buf[q->buf.nextout].msg[2];
-					msg_buf[3] = Buf[q->buf.nextout].msg[3];
-
-					q->buf.nextout = 
-						(q->buf.nextout == q->buf.end) ? q->buf.start : (q->buf.nextout + 1);
-				}
-				break;
-
-			case ERR_TIMEOUT:
-				rtn = ERR_TIMEOUT;
-				break;
-
-			default:
-				printf("\nWait on semaphore call failed");
-				break;
-			}
-		}
-		else
-		{
-			/* message pending */
-			msg_buf[0] = Buf[q->buf.nextout].msg[0];
-			msg_buf[1] = Buf[q->buf.nextout].msg[1];
-			msg_buf[2] = Buf[q->buf.nextout].msg[2];
-			msg_buf[3] = Buf[q->buf.nextout].msg[3];
-
-			q->buf.nextout = 
-				(q->buf.nextout == q->buf.end) ? q->buf.start : (q->buf.nextout + 1);
-		}
+		rtn = &((VMSGHDR *)(q->buf.vbuf + ((pos & q->buf.mask) * q->buf.stride)))->seq;
 	}
 	else
 	{
-		rtn = ERR_OBJID;
+		rtn = &Buf[q->buf.start + (pos & q->buf.mask)].seq;
 	}
 
 	return (rtn);
@@ -379,11 +427,11 @@ ULONG q_receive(ULONG qid, ULONG flags, ULONG timeout, ULONG msg_buf[4])
 
 /******************************************************************************
 *						  
-* Name:				q_send
+* Name:				vslot
 *
 * Type:				Function
 *
-* Description:		
+* Description:		header of the variable length slot at a ring position
 * 
 * Formal Inputs:	
 *
@@ -399,57 +447,91 @@ ULONG q_receive(ULONG qid, ULONG flags, ULONG timeout, ULONG msg_buf[4])
 *
 ******************************************************************************/
 
-ULONG q_send(ULONG qid, ULONG msg_buf[4])
+static VMSGHDR *vslot(QDESC *q, ULONG pos)
 
 {
-	ULONG rtn;
-	QDESC *q;
+	return ((VMSGHDR *)(q->buf.vbuf + ((pos & q->buf.mask) * q->buf.stride)));
+}
+
+/******************************************************************************
+*						  
+* Name:				ring_claim
+*
+* Type:				Function
+*
+* Description:		claim a span of up to n slots whose turn has come
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static ULONG ring_claim(QDESC *q, volatile LONG *cursor, ULONG turn, ULONG n, ULONG *first)
 
-	if ((qid < MAX_Q) && (QTbl[qid].name[0] != '\0'))
+{
+	ULONG cnt;
+	ULONG pos;
+	ULONG seen;
+	LONG dif;
+
+	/*
+	 * turn is 0 on the send side, where a slot is free when its
+	 * sequence equals the position, and 1 on the receive side, where
+	 * it is filled once the sequence is one past it.  other senders
+	 * and receivers may finish their slots out of order, so the span
+	 * stops at the first slot not yet at that turn
+	 */
+
+	cnt = 0;
+	pos = (ULONG)*cursor;
+
+	while (n != 0)
 	{
-		q = &QTbl[qid];
+		for (cnt = 0; cnt < n; cnt++)
+		{
+			if ((ULONG)*ring_seq (q, pos + cnt) != (pos + cnt + turn)) break;
+		}
 
-		if (((q->buf.nextin + 1) == q->buf.nextout) || 
-			((q->buf.nextin == q->buf.end) && (q->buf.nextout == q->buf.start)))
+		if (cnt != 0)
 		{
-			rtn = ERR_QFULL;
+			seen = (ULONG)InterlockedCompareExchange (cursor, (LONG)(pos + cnt), (LONG)pos);
+
+			if (seen == pos) break;
+
+			pos = seen;
 		}
 		else
 		{
-			/* queue message */
-			Buf[q->buf.nextin].msg[0] = msg_buf[0];
-			Buf[q->buf.nextin].msg[1] = msg_buf[1];
-			Buf[q->buf.nextin].msg[2] = msg_buf[2];
-			Buf[q->buf.nextin].msg[3] = msg_buf[3];
+			dif = (LONG)((ULONG)*ring_seq (q, pos) - (pos + turn));
 
-			if (++q->buf.nextin > q->buf.end) q->buf.nextin = q->buf.start;
+			/* a lap behind: ring full on send, empty on receive */
+			if (dif < 0) break;
 
-			/* signal waiting task */
-			if (sm_v (q->semid) == 0)
-			{
-				rtn = 0;
-			}
-			else
-			{
-				printf("\nSend to queue failed");
-			}
+			pos = (ULONG)*cursor;
 		}
 	}
-	else
-	{
-		rtn = ERR_OBJID;
-	}
 
-	return (rtn);
+	*first = pos;
+
+	return (cnt);
 }
 
 /******************************************************************************
 *						  
-* Name:				q_urgent
+* Name:				ring_put
 *
 * Type:				Function
 *
-* Description:		
+* Description:		copy messages into claimed slots and publish them
 * 
 * Formal Inputs:	
 *
@@ -465,20 +547,37 @@ ULONG q_send(ULONG qid, ULONG msg_buf[4])
 *
 ******************************************************************************/
 
-ULONG q_urgent (ULONG qid, ULONG msg_buf[4])
+static void ring_put(QDESC *q, ULONG pos, ULONG *msg_buf, ULONG cnt)
 
 {
-	/* in the future, put message to head of queue */
-	return (q_send (qid, msg_buf));
+	ULONG inx;
+	MSGBUF *slot;
+
+	for (inx = 0; inx < cnt; inx++, msg_buf += 4)
+	{
+		slot = &Buf[q->buf.start + ((pos + inx) & q->buf.mask)];
+
+		slot->msg[0] = msg_buf[0];
+		slot->msg[1] = msg_buf[1];
+		slot->msg[2] = msg_buf[2];
+		slot->msg[3] = msg_buf[3];
+
+		/*
+		 * publish; the interlocked store also orders the caller's
+		 * following read of q->waiters after it
+		 */
+
+		InterlockedExchange (&slot->seq, (LONG)(pos + inx + 1));
+	}
 }
 
 /******************************************************************************
 *						  
-* Name:				q_vcreate
+* Name:				ring_get
 *
 * Type:				Function
 *
-* Description:		
+* Description:		copy messages out of claimed slots and free them
 * 
 * Formal Inputs:	
 *
@@ -494,19 +593,33 @@ ULONG q_urgent (ULONG qid, ULONG msg_buf[4])
 *
 ******************************************************************************/
 
-ULONG q_vcreate(char name[4], ULONG flags, ULONG maxnum, ULONG maxlen, ULONG *qid)
+static void ring_get(QDESC *q, ULONG pos, ULONG *msg_buf, ULONG cnt)
 
 {
-	return (0);
+	ULONG inx;
+	MSGBUF *slot;
+
+	for (inx = 0; inx < cnt; inx++, msg_buf += 4)
+	{
+		slot = &Buf[q->buf.start + ((pos + inx) & q->buf.mask)];
+
+		msg_buf[0] = slot->msg[0];
+		msg_buf[1] = slot->msg[1];
+		msg_buf[2] = slot->msg[2];
+		msg_buf[3] = slot->msg[3];
+
+		/* hand the slot to the sender one lap ahead */
+		InterlockedExchange (&slot->seq, (LONG)(pos + inx + q->buf.mask + 1));
+	}
 }
 
 /******************************************************************************
 *						  
-* Name:				q_vdelete
+* Name:				q_wake
 *
 * Type:				Function
 *
-* Description:		
+* Description:		wake one receiver for each message just published
 * 
 * Formal Inputs:	
 *
@@ -522,19 +635,38 @@ ULONG q_vcreate(char name[4], ULONG flags, ULONG maxnum, ULONG maxlen, ULONG *qi
 *
 ******************************************************************************/
 
-ULONG q_vdelete(ULONG qid)
+static void q_wake(ULONG qid, ULONG cnt, GXKDEFER *defer)
 
 {
-	return (0);
+	if (defer != NULL)
+	{
+		/*
+		 * an asynchronous send leaves the wakeup to the kernel; cnt
+		 * is 0, and qid may not be valid, when nothing was sent
+		 */
+
+		defer->arg[0] = cnt;
+
+		gxk_k_post (defer, ((cnt != 0) && (QTbl[qid].waiters != 0)) ? DF_QWAKE : DF_NOP, qid);
+	}
+	else if ((cnt != 0) && (QTbl[qid].waiters != 0))
+	{
+		/* only enter the kernel when a receiver may be parked */
+		gxk_k_lock ();
+
+		gxk_q_wake (qid, cnt);
+
+		gxk_k_unlock ();
+	}
 }
 
 /******************************************************************************
 *						  
-* Name:				q_vident
+* Name:				ring_empty
 *
 * Type:				Function
 *
-* Description:		
+* Description:		TRUE if the next message to receive is not yet in
 * 
 * Formal Inputs:	
 *
@@ -550,19 +682,23 @@ ULONG q_vdelete(ULONG qid)
 *
 ******************************************************************************/
 
-ULONG q_vident(char name[4], ULONG node, ULONG *qid)
+static UINT ring_empty(QDESC *q)
 
 {
-	return (0);
+	ULONG pos;
+
+	pos = (ULONG)q->buf.nextout;
+
+	return ((ULONG)*ring_seq (q, pos) != (pos + 1));
 }
 
 /******************************************************************************
 *						  
-* Name:				q_vreceive
+* Name:				urg_get
 *
 * Type:				Function
 *
-* Description:		
+* Description:		take up to n urgent messages, newest first
 * 
 * Formal Inputs:	
 *
@@ -578,21 +714,43 @@ ULONG q_vident(char name[4], ULONG node, ULONG *qid)
 *
 ******************************************************************************/
 
-ULONG q_vreceive(ULONG qid, ULONG flags, ULONG timeout, void *msgbuf, ULONG buf_len, ULONG *msg_len)
+static ULONG urg_get(QDESC *q, ULONG *msg_buf, ULONG n)
 
 {
-	q_receive (qid, flags, timeout, msgbuf);
+	ULONG cnt;
+	MSGBUF *slot;
 
-	return (0);
+	cnt = 0;
+
+	if (q->nurg != 0)
+	{
+		gxk_k_lock ();
+
+		for (; (cnt < n) && (q->nurg != 0); cnt++, msg_buf += 4)
+		{
+			slot = &Buf[q->buf.ustart + --q->nurg];
+
+			msg_buf[0] = slot->msg[0];
+			msg_buf[1] = slot->msg[1];
+			msg_buf[2] = slot->msg[2];
+			msg_buf[3] = slot->msg[3];
+		}
+
+		InterlockedExchangeAdd (&q->nclaim, -(LONG)cnt);
+
+		gxk_k_leave ();
+	}
+
+	return (cnt);
 }
 
 /******************************************************************************
 *						  
-* Name:				q_vsend
+* Name:				q_fetch
 *
 * Type:				Function
 *
-* Description:		
+* Description:		take up to n waiting messages without blocking
 * 
 * Formal Inputs:	
 *
@@ -608,21 +766,28 @@ ULONG q_vreceive(ULONG qid, ULONG flags, ULONG timeout, void *msgbuf, ULONG buf_
 *
 ******************************************************************************/
 
-ULONG q_vsend(ULONG qid, void *msgbuf, ULONG msg_len)
+static ULONG q_fetch(QDESC *q, ULONG *msg_buf, ULONG n)
 
 {
-	q_send(qid, msgbuf);
+	ULONG cnt;
+	ULONG more;
+	ULONG pos;
 
-	return (0);
+	cnt = urg_get (q, msg_buf, n);
+
+	more = ring_claim (q, &q->buf.nextout, 1, n - cnt, &pos);
+	ring_get (q, pos, msg_buf + (4 * cnt), more);
+
+	return (cnt + more);
 }
 
 /******************************************************************************
 *						  
-* Name:				gxk_q_init
+* Name:				q_wait
 *
 * Type:				Function
 *
-* Description:		
+* Description:		block until a queue may hold a message
 * 
 * Formal Inputs:	
 *
@@ -638,13 +803,2143 @@ ULONG q_vsend(ULONG qid, void *msgbuf, ULONG msg_len)
 *
 ******************************************************************************/
 
-ULONG gxk_q_init(void)
+static ULONG q_wait(QDESC *q, ULONG flags, ULONG timeout, ULONG *msg_buf)
 
 {
-	ULONG inx;
-	QDESC *q;
+	ULONG rtn;
+	DWORD msecTout;
+	UINT self;
+
+	rtn = 0;
+
+	if (flags & Q_NOWAIT)
+	{
+		rtn = ERR_NOMSG;
+	}
+	else
+	{
+		/*
+		 * count ourselves as a waiter before looking again, so
+		 * a sender either sees the count or its message is found
+		 * here; the kernel lock is held from then until parked.
+		 * the caller claims the message, and waits again if another
+		 * receiver got there first
+		 */
+
+		msecTout = gxk_tm_msec (timeout);
+
+		gxk_k_lock ();
+
+		InterlockedIncrement (&q->waiters);
+
+		if (q->name[0] == '\0')
+		{
+			/* deleted since the caller looked */
+			rtn = ERR_QKILLD;
+		}
+		else if ((q->nurg == 0) && ring_empty (q))
+		{
+			self = gxk_t_self ();
+
+			if (self < MAX_TASK)
+			{
+				RecvBuf[self] = msg_buf;
+			}
+
+			rtn = gxk_t_wait (&q->waitq, msecTout);
+		}
+
+		InterlockedDecrement (&q->waiters);
+
+		gxk_k_unlock ();
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_count
+*
+* Type:				Function
+*
+* Description:		count messages sent and track the deepest the queue has been
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void q_count(QDESC *q, ULONG cnt, ULONG end)
+
+{
+	LONG depth;
+	LONG peak;
+
+	/*
+	 * end is one past the last ring position sent; urgent messages
+	 * waiting count toward the depth
+	 */
+
+	InterlockedExchangeAdd (&q->stats.sent, (LONG)cnt);
+
+	depth = ((LONG)end - q->buf.nextout) + q->nurg;
+
+	while ((peak = q->stats.peak) < depth)
+	{
+		if (InterlockedCompareExchange (&q->stats.peak, depth, peak) == peak) break;
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				q_room
+*
+* Type:				Function
+*
+* Description:		messages the queue can still take
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static LONG q_room(QDESC *q)
+
+{
+	/*
+	 * ring slots not claimed, less the urgent places claimed.  read
+	 * without the lock it is a bound that a sender racing an urgent
+	 * message can overstep by what it sends at once
+	 */
+
+	return ((LONG)(q->buf.mask + 1) - ((LONG)q->buf.nextin - q->buf.nextout) - q->nclaim);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_claim
+*
+* Type:				Function
+*
+* Description:		claim a place on the urgent stack
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static UINT q_claim(QDESC *q)
+
+{
+	LONG claim;
+	LONG seen;
+	UINT rtn;
+
+	/*
+	 * the claim is taken with a compare-exchange, as ring positions
+	 * are, so two urgent senders can't both take the last place and
+	 * the stack never passes its ring size.  gxk_q_push stacks the
+	 * message on it or gives it back
+	 */
+
+	rtn = FALSE;
+	claim = q->nclaim;
+
+	while (((LONG)(q->buf.mask + 1) - ((LONG)q->buf.nextin - q->buf.nextout) - claim) > 0)
+	{
+		seen = InterlockedCompareExchange (&q->nclaim, claim + 1, claim);
+
+		if (seen == claim)
+		{
+			rtn = TRUE;
+			break;
+		}
+
+		claim = seen;
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_hold
+*
+* Type:				Function
+*
+* Description:		count the caller on a queue's ring, if the queue is there
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static UINT q_hold(ULONG qid)
+
+{
+	UINT rtn;
+
+	rtn = FALSE;
+
+	/*
+	 * the caller is counted before it looks at the name, and q_kill
+	 * clears the name before it looks at the count, so a ring is
+	 * only freed once every caller that saw the queue has left it
+	 */
+
+	if (qid < MAX_Q)
+	{
+		InterlockedIncrement (&QTbl[qid].users);
+
+		if (QTbl[qid].name[0] != '\0')
+		{
+			rtn = TRUE;
+		}
+		else
+		{
+			InterlockedDecrement (&QTbl[qid].users);
+		}
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_drop
+*
+* Type:				Function
+*
+* Description:		let go of a hold on a queue's ring
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void q_drop(QDESC *q)
+
+{
+	InterlockedDecrement (&q->users);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_put
+*
+* Type:				Function
+*
+* Description:		queue up to n fixed length messages
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static ULONG q_put(ULONG qid, ULONG *msg_buf, ULONG n, ULONG *count, GXKDEFER *defer)
+
+{
+	ULONG rtn;
+	ULONG cnt;
+	ULONG pos;
+	ULONG want;
+	LONG room;
+	QDESC *q;
+
+	rtn = 0;
+	cnt = 0;
+
+	if (q_hold (qid) == FALSE)
+	{
+		rtn = ERR_OBJID;
+	}
+	else
+	{
+		q = &QTbl[qid];
+
+		if (q->var)
+		{
+			rtn = ERR_VARQ;
+		}
+		else
+		{
+			/* claimed urgent places take their share of the ring */
+			want = n;
+
+			if (q->nclaim != 0)
+			{
+				room = q_room (q);
+				want = (room <= 0) ? 0 : (((ULONG)room < n) ? (ULONG)room : n);
+			}
+
+			cnt = ring_claim (q, &q->buf.nextin, 0, want, &pos);
+			ring_put (q, pos, msg_buf, cnt);
+
+			q_count (q, cnt, pos + cnt);
+
+			if (cnt < n)
+			{
+				InterlockedExchangeAdd (&q->stats.drops, (LONG)(n - cnt));
+
+				rtn = ERR_QFULL;
+			}
+		}
+
+		q_drop (q);
+	}
+
+	q_wake (qid, cnt, defer);
+
+	GXK_TRACE (TR_QSEND, qid, rtn, cnt);
+
+	*count = cnt;
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_commit
+*
+* Type:				Function
+*
+* Description:		publish a message built in place by q_vreserve
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static ULONG q_commit(ULONG qid, void *msgbuf, ULONG msg_len, GXKDEFER *defer)
+
+{
+	ULONG rtn;
+	ULONG cnt;
+	VMSGHDR *hdr;
+
+	rtn = 0;
+	cnt = 0;
+
+	/*
+	 * the hold q_vreserve took on the ring is let go here, also when
+	 * the queue was deleted meanwhile; a message too long keeps the
+	 * slot reserved for another try
+	 */
+
+	if ((qid >= MAX_Q) || (QTbl[qid].var == FALSE))
+	{
+		rtn = (qid >= MAX_Q) ? ERR_OBJID : ERR_NOTVARQ;
+	}
+	else if (QTbl[qid].name[0] == '\0')
+	{
+		rtn = ERR_OBJID;
+
+		q_drop (&QTbl[qid]);
+	}
+	else if (msg_len > QTbl[qid].maxlen)
+	{
+		rtn = ERR_MSGSIZ;
+	}
+	else
+	{
+		hdr = (VMSGHDR *)msgbuf - 1;
+
+		hdr->len = msg_len;
+
+		/* publish, as ring_put does */
+		InterlockedExchange (&hdr->seq, (LONG)(hdr->pos + 1));
+
+		cnt = 1;
+
+		q_count (&QTbl[qid], cnt, hdr->pos + 1);
+
+		q_drop (&QTbl[qid]);
+	}
+
+	q_wake (qid, cnt, defer);
+
+	GXK_TRACE (TR_QSEND, qid, rtn, cnt);
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_vput
+*
+* Type:				Function
+*
+* Description:		copy in and send a variable length message
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static ULONG q_vput(ULONG qid, void *msgbuf, ULONG msg_len, GXKDEFER *defer)
+
+{
+	ULONG rtn;
+	void *slot;
+
+	if ((qid < MAX_Q) && (QTbl[qid].var) && (msg_len > QTbl[qid].maxlen))
+	{
+		rtn = ERR_MSGSIZ;
+	}
+	else
+	{
+		rtn = q_vreserve (qid, &slot);
+	}
+
+	if (rtn == 0)
+	{
+		memcpy (slot, msgbuf, msg_len);
+
+		rtn = q_commit (qid, slot, msg_len, defer);
+	}
+	else
+	{
+		/* nothing sent; lets go of the deferred work slot */
+		q_wake (qid, 0, defer);
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_take
+*
+* Type:				Function
+*
+* Description:		receive up to n fixed length messages
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static ULONG q_take(ULONG qid, ULONG flags, ULONG timeout, ULONG *msg_buf, ULONG n, ULONG *count)
+
+{
+	ULONG rtn;
+	QDESC *q;
+
+	rtn = 0;
+	*count = 0;
+
+	if (q_hold (qid) == FALSE)
+	{
+		rtn = ERR_OBJID;
+	}
+	else
+	{
+		q = &QTbl[qid];
+
+		if (q->var)
+		{
+			rtn = ERR_VARQ;
+		}
+		else
+		{
+			/*
+			 * the hold is kept while blocked; q_delete wakes the
+			 * receiver, which leaves without touching the ring
+			 */
+
+			while (((*count = q_fetch (q, msg_buf, n)) == 0) && (n != 0))
+			{
+				if ((rtn = q_wait (q, flags, timeout, msg_buf)) != 0)
+				{
+					if (rtn == Q_HANDOFF)
+					{
+						/* q_broadcast already filled msg_buf */
+						*count = 1;
+						rtn = 0;
+					}
+
+					break;
+				}
+			}
+
+			InterlockedExchangeAdd (&q->stats.received, (LONG)*count);
+		}
+
+		q_drop (q);
+	}
+
+	GXK_TRACE (TR_QRECV, qid, rtn, *count);
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_reclaim
+*
+* Type:				Function
+*
+* Description:		give back the ring of a deleted queue nobody is on
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static UINT q_reclaim(QDESC *q)
+
+{
+	UINT rtn;
+
+	rtn = FALSE;
+
+	/*
+	 * called with the kernel locked on a queue whose name is cleared;
+	 * TRUE when the slot holds no ring and can be reused.  the count
+	 * is read interlocked, after the name was cleared
+	 */
+
+	if (InterlockedCompareExchange (&q->users, 0, 0) == 0)
+	{
+		if (q->buf.vbuf != NULL)
+		{
+			free (q->buf.vbuf);
+			q->buf.vbuf = NULL;
+		}
+
+		if (q->buf.start != NO_BUF)
+		{
+			buf_free (q->buf.start, q->buf.order);
+			q->buf.start = NO_BUF;
+		}
+
+		if (q->buf.ustart != NO_BUF)
+		{
+			buf_free (q->buf.ustart, q->buf.order);
+			q->buf.ustart = NO_BUF;
+		}
+
+		rtn = TRUE;
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_slot
+*
+* Type:				Function
+*
+* Description:		find a free queue slot
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static ULONG q_slot(void)
+
+{
+	ULONG inx;
+	ULONG rtn;
+
+	rtn = MAX_Q;
+
+	/*
+	 * called with the kernel locked; the first free slot, or MAX_Q.
+	 * rings kept by callers when their queues were deleted are given
+	 * back on the way once those callers have left
+	 */
+
+	for (inx = 0; inx < MAX_Q; inx++)
+	{
+		if ((QTbl[inx].name[0] == '\0') && q_reclaim (&QTbl[inx]) && (rtn == MAX_Q))
+		{
+			rtn = inx;
+		}
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_kill
+*
+* Type:				Function
+*
+* Description:		delete a fixed or variable length queue
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static ULONG q_kill(ULONG qid, UINT var)
+
+{
+	ULONG rtn;
+	ULONG count;
+	QDESC *q;
+
+	rtn = 0;
+
+	if (qid < MAX_Q)
+	{
+		gxk_k_lock ();
+
+		q = &QTbl[qid];
+
+		if (q->name[0] == '\0')
+		{
+			rtn = ERR_OBJID;
+		}
+		else if (q->var != var)
+		{
+			rtn = (var) ? ERR_NOTVARQ : ERR_VARQ;
+		}
+		else
+		{
+			gxk_nm_remove ((var) ? NM_VQUEUE : NM_QUEUE, q->name, qid);
+			gxk_nd_unexport ((var) ? NM_VQUEUE : NM_QUEUE, qid);
+
+			q->name[0] = '\0';
+
+			count = gxk_t_flush (&q->waitq, ERR_QKILLD);
+
+			if (q->selectors != 0)
+			{
+				count += gxk_sl_post (SL_QUEUE, qid, ERR_QKILLD);
+			}
+
+			if (count != 0)
+			{
+				rtn = ERR_TATQDEL;
+			}
+			else if ((q->buf.nextin != q->buf.nextout) || (q->nurg != 0))
+			{
+				rtn = ERR_MATQDEL;
+			}
+
+			/*
+			 * a sender or receiver still on the ring without the
+			 * lock keeps it, and the slot, until it is done
+			 */
+
+			q_reclaim (q);
+		}
+
+		gxk_k_unlock ();
+	}
+	else
+	{
+		rtn = ERR_OBJID;
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_asend
+*
+* Type:				Function
+*
+* Description:		q_send from interrupt level
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG q_asend(ULONG qid, ULONG msg_buf[4])
+
+{
+	ULONG rtn;
+	ULONG cnt;
+	GXKDEFER *defer;
+
+	if ((defer = gxk_k_claim ()) == NULL)
+	{
+		rtn = ERR_ASFULL;
+	}
+	else
+	{
+		rtn = q_put (qid, msg_buf, 1, &cnt, defer);
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_aurgent
+*
+* Type:				Function
+*
+* Description:		q_urgent from interrupt level
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG q_aurgent(ULONG qid, ULONG msg_buf[4])
+
+{
+	ULONG rtn;
+	GXKDEFER *defer;
+
+	rtn = 0;
+
+	/*
+	 * the urgent stack belongs to the kernel lock, so the message is
+	 * carried in the deferred work slot and stacked by gxk_q_push.
+	 * its place is claimed now, so a queue that fills before the
+	 * kernel gets to the message still has room for it
+	 */
+
+	if ((qid >= MAX_Q) || (QTbl[qid].name[0] == '\0'))
+	{
+		rtn = ERR_OBJID;
+	}
+	else if (QTbl[qid].var)
+	{
+		rtn = ERR_VARQ;
+	}
+	else if (q_claim (&QTbl[qid]) == FALSE)
+	{
+		InterlockedIncrement (&QTbl[qid].stats.drops);
+
+		rtn = ERR_QFULL;
+	}
+	else if ((defer = gxk_k_claim ()) == NULL)
+	{
+		InterlockedDecrement (&QTbl[qid].nclaim);
+
+		rtn = ERR_ASFULL;
+	}
+	else
+	{
+		defer->arg[0] = msg_buf[0];
+		defer->arg[1] = msg_buf[1];
+		defer->arg[2] = msg_buf[2];
+		defer->arg[3] = msg_buf[3];
+
+		gxk_k_post (defer, DF_QURGENT, qid);
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_avsend
+*
+* Type:				Function
+*
+* Description:		q_vsend from interrupt level
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG q_avsend(ULONG qid, void *msgbuf, ULONG msg_len)
+
+{
+	ULONG rtn;
+	GXKDEFER *defer;
+
+	if ((defer = gxk_k_claim ()) == NULL)
+	{
+		rtn = ERR_ASFULL;
+	}
+	else
+	{
+		rtn = q_vput (qid, msgbuf, msg_len, defer);
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_broadcast
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+		  
+ULONG q_broadcast(ULONG qid, ULONG msg_buf[4], ULONG *count)
+
+{
+	ULONG rtn;
+	ULONG cnt;
+	UINT tid;
+	ULONG *dst;
+	QDESC *q;
+
+	rtn = 0;
+	cnt = 0;
+
+	if ((qid >= MAX_Q) || (QTbl[qid].name[0] == '\0'))
+	{
+		rtn = ERR_OBJID;
+	}
+	else if (QTbl[qid].var)
+	{
+		rtn = ERR_VARQ;
+	}
+	else
+	{
+		q = &QTbl[qid];
+
+		/*
+		 * one pass over the blocked receivers, each gets its own copy;
+		 * with none blocked the message is not queued
+		 */
+
+		gxk_k_lock ();
+
+		while ((tid = gxk_t_wake (&q->waitq, Q_HANDOFF)) != MAX_TASK)
+		{
+			dst = RecvBuf[tid];
+
+			dst[0] = msg_buf[0];
+			dst[1] = msg_buf[1];
+			dst[2] = msg_buf[2];
+			dst[3] = msg_buf[3];
+
+			++cnt;
+		}
+
+		/* each copy is sent and, by the hand-off, received */
+		InterlockedExchangeAdd (&q->stats.sent, (LONG)cnt);
+
+		gxk_k_unlock ();
+	}
+
+	*count = cnt;
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_create
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG q_create(char name[4], ULONG count, ULONG flags, ULONG *qid)
+
+{
+	ULONG rtn;
+	ULONG inx;
+	ULONG size;
+	ULONG order;
+	ULONG blk;
+	QDESC *q;
+
+	rtn = 0;
+	blk = NO_BUF;
+
+	/*
+	 * ring size is count rounded up to a power of two
+	 */
+
+	for (order = 0; ((1UL << order) < count) && (order < BUF_ORDERS); order++)
+	{
+	}
+
+	size = 1UL << order;
+
+	*qid = MAX_Q;
+
+	gxk_k_lock ();
+
+	if ((inx = q_slot ()) == MAX_Q)
+	{
+		rtn = ERR_NOQCB;
+	}
+	else if ((order >= BUF_ORDERS) || ((blk = buf_alloc (order)) == NO_BUF))
+	{
+		rtn = ERR_NOMGB;
+	}
+	else
+	{
+		q = &QTbl[inx];
+
+		*qid = inx;
+
+		q->count = count;
+		q->flags = flags;
+		q->var = FALSE;
+		InterlockedExchangeAdd (&q->nclaim, -q->nurg);
+		q->nurg = 0;
+		q->selectors = 0;
+		q->stats.sent = q->stats.drops = q->stats.peak = q->stats.received = 0;
+		gxk_t_initq (&q->waitq, (flags & Q_PRIOR) != 0);
+
+		q->buf.start = blk;
+		q->buf.order = order;
+		q->buf.ustart = NO_BUF;
+		q->buf.mask = size - 1;
+		q->buf.nextin = q->buf.nextout = 0;
+
+		for (inx = 0; inx < size; inx++)
+		{
+			Buf[q->buf.start + inx].seq = (LONG)inx;
+		}
+
+		/*
+		 * the name goes in last, so a caller never finds the queue
+		 * before its ring
+		 */
+
+		q->name[1] = name[1];
+		q->name[2] = name[2];
+		q->name[3] = name[3];
+		q->name[0] = name[0];
+
+		gxk_nm_add (NM_QUEUE, q->name, *qid);
+
+		if (flags & Q_GLOBAL)
+		{
+			gxk_nd_export (NM_QUEUE, q->name, *qid);
+		}
+	}
+
+	gxk_k_leave ();
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_delete
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG q_delete(ULONG qid)
+
+{
+	return (q_kill (qid, FALSE));
+}
+
+/******************************************************************************
+*						  
+* Name:				q_ident
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG q_ident(char name[4], ULONG node, ULONG *qid)
+
+{
+	ULONG rtn;
+
+	rtn = gxk_nd_ident (NM_QUEUE, name, node, qid);
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_info
+*
+* Type:				Function
+*
+* Description:		snapshot the statistics of a fixed or variable length queue
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG q_info(ULONG qid, struct qinfo *info)
+
+{
+	ULONG rtn;
+	LONG depth;
+	QDESC *q;
+
+	rtn = 0;
+
+	/*
+	 * the counters are read without stopping senders and receivers,
+	 * so each is current but they may be a message apart
+	 */
+
+	if ((qid >= MAX_Q) || (QTbl[qid].name[0] == '\0'))
+	{
+		rtn = ERR_OBJID;
+	}
+	else
+	{
+		q = &QTbl[qid];
+
+		depth = (q->buf.nextin - q->buf.nextout) + q->nurg;
+
+		info->count = (depth > 0) ? (ULONG)depth : 0;
+		info->peak = (ULONG)q->stats.peak;
+		info->sent = (ULONG)q->stats.sent;
+		info->received = (ULONG)q->stats.received;
+		info->drops = (ULONG)q->stats.drops;
+		info->waiting = (ULONG)q->waiters;
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_receive
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG q_receive(ULONG qid, ULONG flags, ULONG timeout, ULONG msg_buf[4])
+
+{
+	ULONG cnt;
+
+	return (q_take (qid, flags, timeout, msg_buf, 1, &cnt));
+}
+
+/******************************************************************************
+*						  
+* Name:				q_receive_n
+*
+* Type:				Function
+*
+* Description:		receive up to n messages; timeout applies to the first
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG q_receive_n(ULONG qid, ULONG flags, ULONG timeout, ULONG msg_buf[][4], ULONG n, ULONG *count)
+
+{
+	return (q_take (qid, flags, timeout, msg_buf[0], n, count));
+}
+
+/******************************************************************************
+*						  
+* Name:				q_send
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG q_send(ULONG qid, ULONG msg_buf[4])
+
+{
+	ULONG rtn;
+	ULONG cnt;
+
+	if (ND_NODE (qid) != 0)
+	{
+		/* batched into the next frame to the queue's node */
+		rtn = gxk_nd_send (ND_QSEND, qid, msg_buf);
+	}
+	else
+	{
+		rtn = q_put (qid, msg_buf, 1, &cnt, NULL);
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_send_n
+*
+* Type:				Function
+*
+* Description:		send n messages; ERR_QFULL if only *count of them fit
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG q_send_n(ULONG qid, ULONG msg_buf[][4], ULONG n, ULONG *count)
+
+{
+	return (q_put (qid, msg_buf[0], n, count, NULL));
+}
+
+/******************************************************************************
+*						  
+* Name:				q_urgent
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG q_urgent (ULONG qid, ULONG msg_buf[4])
+
+{
+	ULONG rtn;
+
+	if (ND_NODE (qid) != 0)
+	{
+		rtn = gxk_nd_send (ND_QURGENT, qid, msg_buf);
+	}
+	else if ((qid >= MAX_Q) || (QTbl[qid].name[0] == '\0'))
+	{
+		rtn = ERR_OBJID;
+	}
+	else if (QTbl[qid].var)
+	{
+		rtn = ERR_VARQ;
+	}
+	else if (q_claim (&QTbl[qid]) == FALSE)
+	{
+		InterlockedIncrement (&QTbl[qid].stats.drops);
+
+		rtn = ERR_QFULL;
+	}
+	else
+	{
+		gxk_k_lock ();
+
+		rtn = gxk_q_push (qid, msg_buf);
+
+		gxk_k_unlock ();
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_vborrow
+*
+* Type:				Function
+*
+* Description:		receive a variable length message in place
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG q_vborrow(ULONG qid, ULONG flags, ULONG timeout, void **msgbuf, ULONG *msg_len)
+
+{
+	ULONG rtn;
+	ULONG pos;
+	ULONG cnt;
+	VMSGHDR *hdr;
+	QDESC *q;
+
+	rtn = 0;
+
+	/*
+	 * the slot stays the caller's until q_vrelease; later messages
+	 * are still received, but senders cannot reuse it on the next lap
+	 */
+
+	if (q_hold (qid) == FALSE)
+	{
+		rtn = ERR_OBJID;
+	}
+	else if (QTbl[qid].var == FALSE)
+	{
+		rtn = ERR_NOTVARQ;
+
+		q_drop (&QTbl[qid]);
+	}
+	else
+	{
+		q = &QTbl[qid];
+
+		while ((cnt = ring_claim (q, &q->buf.nextout, 1, 1, &pos)) == 0)
+		{
+			if ((rtn = q_wait (q, flags, timeout, NULL)) != 0) break;
+		}
+
+		/* a borrowed slot keeps the hold until q_vrelease */
+		if (cnt != 0)
+		{
+			hdr = vslot (q, pos);
+			hdr->pos = pos;
+
+			*msgbuf = (void *)(hdr + 1);
+			*msg_len = hdr->len;
+
+			InterlockedIncrement (&q->stats.received);
+		}
+		else
+		{
+			q_drop (q);
+		}
+	}
+
+	GXK_TRACE (TR_QRECV, qid, rtn, (rtn == 0));
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_vcommit
+*
+* Type:				Function
+*
+* Description:		send a message built in place by q_vreserve
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG q_vcommit(ULONG qid, void *msgbuf, ULONG msg_len)
+
+{
+	return (q_commit (qid, msgbuf, msg_len, NULL));
+}
+
+/******************************************************************************
+*						  
+* Name:				q_vcreate
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG q_vcreate(char name[4], ULONG flags, ULONG maxnum, ULONG maxlen, ULONG *qid)
+
+{
+	ULONG rtn;
+	ULONG inx;
+	ULONG size;
+	ULONG stride;
+	char *vbuf;
+	QDESC *q;
+
+	rtn = 0;
+	vbuf = NULL;
+	*qid = MAX_Q;
+
+	/*
+	 * maxnum slots rounded up to a power of two, each a VMSGHDR and
+	 * maxlen bytes kept ULONG aligned.  the ring is allocated before
+	 * the kernel is locked, and the sizes are checked first so the
+	 * rounding and the product cannot wrap
+	 */
+
+	if ((maxnum == 0) || (maxnum > ((ULONG)1 << (sizeof (ULONG) * 8 - 1))) ||
+		(maxlen > (ULONG)-1 - sizeof (VMSGHDR) - sizeof (ULONG)))
+	{
+		return (ERR_MAXMSG);
+	}
+
+	for (size = 1; size < maxnum; size <<= 1)
+	{
+	}
+
+	stride = (sizeof (VMSGHDR) + maxlen + sizeof (ULONG) - 1) & ~(sizeof (ULONG) - 1);
+
+	if ((size > (size_t)-1 / stride) || ((vbuf = (char *)malloc ((size_t)size * stride)) == NULL))
+	{
+		return (ERR_NOMGB);
+	}
+
+	gxk_k_lock ();
+
+	if ((inx = q_slot ()) == MAX_Q)
+	{
+		rtn = ERR_NOQCB;
+
+		free (vbuf);
+	}
+	else
+	{
+		q = &QTbl[inx];
+
+		*qid = inx;
+
+		q->count = maxnum;
+		q->flags = flags;
+		q->var = TRUE;
+		q->maxlen = maxlen;
+		InterlockedExchangeAdd (&q->nclaim, -q->nurg);
+		q->nurg = 0;
+		q->stats.sent = q->stats.drops = q->stats.peak = q->stats.received = 0;
+		gxk_t_initq (&q->waitq, (flags & Q_PRIOR) != 0);
+
+		q->buf.start = NO_BUF;
+		q->buf.vbuf = vbuf;
+		q->buf.stride = stride;
+		q->buf.ustart = NO_BUF;
+		q->buf.mask = size - 1;
+		q->buf.nextin = q->buf.nextout = 0;
+
+		for (inx = 0; inx < size; inx++)
+		{
+			vslot (q, inx)->seq = (LONG)inx;
+		}
+
+		/* the name last, as q_create does */
+		q->name[1] = name[1];
+		q->name[2] = name[2];
+		q->name[3] = name[3];
+		q->name[0] = name[0];
+
+		gxk_nm_add (NM_VQUEUE, q->name, *qid);
+	}
+
+	gxk_k_leave ();
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_vdelete
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG q_vdelete(ULONG qid)
+
+{
+	return (q_kill (qid, TRUE));
+}
+
+/******************************************************************************
+*						  
+* Name:				q_vident
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG q_vident(char name[4], ULONG node, ULONG *qid)
+
+{
+	ULONG rtn;
+
+	/* variable length queues are never global, so only this node is searched */
+	(void)node;
+
+	gxk_k_lock ();
+	rtn = gxk_nm_find (NM_VQUEUE, name, qid);
+	gxk_k_leave ();
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_vreceive
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG q_vreceive(ULONG qid, ULONG flags, ULONG timeout, void *msgbuf, ULONG buf_len, ULONG *msg_len)
+
+{
+	ULONG rtn;
+	void *slot;
+
+	rtn = q_vborrow (qid, flags, timeout, &slot, msg_len);
+
+	if (rtn == 0)
+	{
+		/* a message too long for the buffer is still taken off the queue */
+		if (*msg_len > buf_len)
+		{
+			rtn = ERR_BUFSIZ;
+		}
+		else
+		{
+			memcpy (msgbuf, slot, *msg_len);
+		}
+
+		q_vrelease (qid, slot);
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_vrelease
+*
+* Type:				Function
+*
+* Description:		give back a slot taken by q_vborrow
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG q_vrelease(ULONG qid, void *msgbuf)
+
+{
+	ULONG rtn;
+	VMSGHDR *hdr;
+	QDESC *q;
+
+	rtn = 0;
+
+	/*
+	 * a slot borrowed from a queue deleted since is still given back,
+	 * as the ring is kept until it is
+	 */
+
+	if (qid >= MAX_Q)
+	{
+		rtn = ERR_OBJID;
+	}
+	else if (QTbl[qid].var == FALSE)
+	{
+		rtn = ERR_NOTVARQ;
+	}
+	else
+	{
+		q = &QTbl[qid];
+		hdr = (VMSGHDR *)msgbuf - 1;
+
+		/* hand the slot to the sender one lap ahead, as ring_get does */
+		InterlockedExchange (&hdr->seq, (LONG)(hdr->pos + q->buf.mask + 1));
+
+		q_drop (q);
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_vreserve
+*
+* Type:				Function
+*
+* Description:		claim a free slot to build a variable length message in
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG q_vreserve(ULONG qid, void **msgbuf)
+
+{
+	ULONG rtn;
+	ULONG pos;
+	VMSGHDR *hdr;
+	QDESC *q;
+
+	rtn = 0;
+
+	if (q_hold (qid) == FALSE)
+	{
+		rtn = ERR_OBJID;
+	}
+	else if (QTbl[qid].var == FALSE)
+	{
+		rtn = ERR_NOTVARQ;
+
+		q_drop (&QTbl[qid]);
+	}
+	else
+	{
+		q = &QTbl[qid];
+
+		if (ring_claim (q, &q->buf.nextin, 0, 1, &pos) == 0)
+		{
+			InterlockedIncrement (&q->stats.drops);
+
+			rtn = ERR_QFULL;
+
+			q_drop (q);
+		}
+		else
+		{
+			/*
+			 * receivers stop at this slot until q_vcommit, so the
+			 * message should be filled and committed promptly; the
+			 * hold on the ring is kept until then
+			 */
+
+			hdr = vslot (q, pos);
+			hdr->pos = pos;
+
+			*msgbuf = (void *)(hdr + 1);
+		}
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				q_vsend
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG q_vsend(ULONG qid, void *msgbuf, ULONG msg_len)
+
+{
+	return (q_vput (qid, msgbuf, msg_len, NULL));
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_q_fetch
+*
+* Type:				Function
+*
+* Description:		take one message for a task waiting in sl_wait
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_q_fetch(ULONG qid, ULONG msg_buf[4])
+
+{
+	ULONG cnt;
+	QDESC *q;
+
+	cnt = 0;
+
+	/*
+	 * called with the kernel locked; returns the messages taken
+	 */
+
+	q = &QTbl[qid];
+
+	if ((q->name[0] != '\0') && (!q->var))
+	{
+		if ((cnt = q_fetch (q, msg_buf, 1)) != 0)
+		{
+			InterlockedIncrement (&q->stats.received);
+
+			GXK_TRACE (TR_QRECV, qid, 0, cnt);
+		}
+	}
+
+	return (cnt);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_q_push
+*
+* Type:				Function
+*
+* Description:		stack an urgent message and wake a receiver
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_q_push(ULONG qid, ULONG msg_buf[4])
+
+{
+	ULONG rtn;
+	QDESC *q;
+	MSGBUF *slot;
+
+	rtn = 0;
+
+	/*
+	 * called with the kernel locked and a place claimed by q_claim,
+	 * which is given back if the message can't be stacked.  the queue
+	 * may have gone since a q_aurgent posted the message, or been
+	 * remade smaller in its slot
+	 */
+
+	q = &QTbl[qid];
+
+	if ((q->name[0] == '\0') || (q->var))
+	{
+		InterlockedDecrement (&q->nclaim);
+
+		rtn = ERR_OBJID;
+	}
+	else if ((ULONG)q->nurg > q->buf.mask)
+	{
+		InterlockedDecrement (&q->nclaim);
+		InterlockedIncrement (&q->stats.drops);
+
+		rtn = ERR_QFULL;
+	}
+	else if ((q->buf.ustart == NO_BUF) && ((q->buf.ustart = buf_alloc (q->buf.order)) == NO_BUF))
+	{
+		InterlockedDecrement (&q->nclaim);
+
+		rtn = ERR_NOMGB;
+	}
+	else
+	{
+		slot = &Buf[q->buf.ustart + q->nurg];
+
+		slot->msg[0] = msg_buf[0];
+		slot->msg[1] = msg_buf[1];
+		slot->msg[2] = msg_buf[2];
+		slot->msg[3] = msg_buf[3];
+
+		++q->nurg;
+
+		q_count (q, 1, q->buf.nextin);
+
+		gxk_q_wake (qid, 1);
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_q_select
+*
+* Type:				Function
+*
+* Description:		count a task in sl_wait among a queue's waiters, or stop counting it
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_q_select(ULONG qid, UINT on)
+
+{
+	ULONG rtn;
+	QDESC *q;
+
+	rtn = 0;
+
+	/*
+	 * called with the kernel locked.  a waiter count makes senders
+	 * enter the kernel, where gxk_q_wake finds the selector
+	 */
+
+	if (!on)
+	{
+		q = &QTbl[qid];
+
+		--q->selectors;
+		InterlockedDecrement (&q->waiters);
+	}
+	else if ((qid >= MAX_Q) || (QTbl[qid].name[0] == '\0'))
+	{
+		rtn = ERR_OBJID;
+	}
+	else if (QTbl[qid].var)
+	{
+		rtn = ERR_VARQ;
+	}
+	else
+	{
+		q = &QTbl[qid];
+
+		++q->selectors;
+		InterlockedIncrement (&q->waiters);
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_q_wake
+*
+* Type:				Function
+*
+* Description:		wake up to cnt receivers
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_q_wake(ULONG qid, ULONG cnt)
+
+{
+	ULONG inx;
+
+	/*
+	 * called with the kernel locked
+	 */
+
+	for (inx = 0; inx < cnt; inx++)
+	{
+		if (gxk_t_wake (&QTbl[qid].waitq, 0) == MAX_TASK) break;
+	}
+
+	/* what no receiver was woken for may end an sl_wait */
+	if ((inx < cnt) && (QTbl[qid].selectors != 0))
+	{
+		gxk_sl_post (SL_QUEUE, qid, 0);
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_q_init
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_q_init(void)
+
+{
+	ULONG inx;
+	QDESC *q;
+
+	for (inx = 0; inx < BUF_ORDERS; inx++)
+	{
+		FreeHead[inx] = NO_BUF;
+	}
+
+	for (inx = 0; inx < MAX_BUF; inx++)
+	{
+		BufTag[inx] = 0;
+	}
 
-	NextAvailBuf = 0;
+	buf_link (0, BUF_ORDERS - 1);
 
 	for (inx = 0; inx < MAX_Q; inx++)
 	{
@@ -653,9 +2948,20 @@ ULONG gxk_q_init(void)
 		q->name[0] = '\0';
 		q->count = 0;
 		q->flags = 0;
-		q->semname[0] = '\0';
-		q->semid = 0;
-		q->buf.start = q->buf.end = q->buf.nextin = q->buf.nextout = 0;
+		q->var = FALSE;
+		q->maxlen = 0;
+		q->waiters = 0;
+		q->users = 0;
+		q->selectors = 0;
+		q->nurg = q->nclaim = 0;
+		q->stats.sent = q->stats.drops = q->stats.peak = q->stats.received = 0;
+		gxk_t_initq (&q->waitq, FALSE);
+		q->buf.start = NO_BUF;
+		q->buf.order = q->buf.mask = 0;
+		q->buf.ustart = NO_BUF;
+		q->buf.nextin = q->buf.nextout = 0;
+		q->buf.vbuf = NULL;
+		q->buf.stride = 0;
 	}
 
 	return (0);
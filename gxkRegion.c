@@ -0,0 +1,1116 @@
+/************************************BEGIN*****************************************
+*                       COPYRIGHT %G% %U% BY GHWORKS, LLC 
+*                             ALL RIGHTS RESERVED
+*                         SPDX-License-Identifier: MIT
+* ********************************************************************************
+* Name:        gxkRegion
+* Type:        C Source
+* File:        %M%
+* Version:     %I%
+* Description: Region Services Interface
+*
+* Interface (public) Routines:
+*
+*	rn_create
+*	rn_delete
+*	rn_getseg
+*	rn_ident
+*	rn_retseg
+*
+*	gxk_rn_init
+*	gxk_rn_purge
+*
+* Private Functions:
+*
+*	bit_high
+*	bit_low
+*	blk_alloc
+*	blk_free
+*	blk_mark
+*	list_insert
+*	list_remove
+*	rn_serve
+*	tlsf_find
+*	tlsf_map
+*
+* Modification History:
+* ----------------------------------------------------------- 
+* Date		Initials		Change Description
+* -----------------------------------------------------------
+* 10/14/26	GVH				Created
+*
+**************************************END***************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "gxkHost.h"
+#if !defined(__GNUC__)
+#include <intrin.h>
+#endif
+#include "gxkernel.h"
+#include "gxkCfg.h"
+#include "gxkSys.h"
+
+/********************************
+		LOCAL DECLARATIONS
+********************************/
+
+/*
+ * a region is managed in units with a two level segregated fit
+ * (TLSF) index: the first level splits free block sizes by power of
+ * two, the second splits each power into SL_COUNT linear steps, and
+ * a bitmap per level finds the smallest non-empty list that must fit
+ * with two bit scans.  allocate and free are O(1) whatever the
+ * region's state.
+ *
+ * the front of the region holds one tag word per unit.  only the
+ * first and last unit of a block carry a tag, its size and whether
+ * it is free, so a freed segment finds both neighbours in constant
+ * time and coalesces with them; interior tags are kept zero so a
+ * stray address inside a segment is refused.  free blocks are linked
+ * through their own first unit
+ */
+
+#define SL_BITS				4
+#define SL_COUNT			(1 << SL_BITS)
+#define FL_COUNT			(32 - SL_BITS + 1)
+
+#define NO_UNIT				0xFFFFFFFF
+
+#define TAG_HEAD			0x80000000				/* first unit of a block */
+#define TAG_FREE			0x40000000
+#define TAG_SIZE(t)			((t) & 0x3FFFFFFF)		/* block size in units */
+
+#define UNIT_ADDR(rn, u)	((rn)->base + ((DWORD_PTR)(u) << (rn)->shift))
+#define UNIT_NEXT(rn, u)	(((ULONG *)UNIT_ADDR (rn, u))[0])
+#define UNIT_PREV(rn, u)	(((ULONG *)UNIT_ADDR (rn, u))[1])
+
+typedef struct
+{
+	char name[4];
+	ULONG flags;
+	char *base;					/* first unit */
+	UINT shift;					/* log2 unit_size */
+	ULONG units;
+	ULONG nfree;				/* units not allocated */
+	ULONG *tag;
+	ULONG flmap;
+	ULONG slmap[FL_COUNT];
+	ULONG free[FL_COUNT][SL_COUNT];
+	GXKWAITQ waitq;
+} RNDESC;
+
+/********************************
+		GLOBALS
+********************************/
+
+RNDESC RnTbl[MAX_REGION];
+
+ULONG RnWant[MAX_TASK];		/* units a blocked rn_getseg asked for */
+char *RnGot[MAX_TASK];		/* segment rn_retseg handed it */
+
+/******************************************************************************
+*						  
+* Name:				bit_high
+*
+* Type:				Function
+*
+* Description:		index of the highest set bit
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static UINT bit_high(ULONG x)
+
+{
+#if defined(__GNUC__)
+	return (31 - __builtin_clz ((unsigned)x));
+#else
+	unsigned long inx;
+
+	_BitScanReverse (&inx, x);
+
+	return ((UINT)inx);
+#endif
+}
+
+/******************************************************************************
+*						  
+* Name:				bit_low
+*
+* Type:				Function
+*
+* Description:		index of the lowest set bit
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static UINT bit_low(ULONG x)
+
+{
+#if defined(__GNUC__)
+	return (__builtin_ctz ((unsigned)x));
+#else
+	unsigned long inx;
+
+	_BitScanForward (&inx, x);
+
+	return ((UINT)inx);
+#endif
+}
+
+/******************************************************************************
+*						  
+* Name:				tlsf_map
+*
+* Type:				Function
+*
+* Description:		free list holding blocks of a size
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void tlsf_map(ULONG n, UINT *fl, UINT *sl)
+
+{
+	UINT msb;
+
+	if (n < SL_COUNT)
+	{
+		*fl = 0;
+		*sl = (UINT)n;
+	}
+	else
+	{
+		msb = bit_high (n);
+
+		*fl = msb - SL_BITS + 1;
+		*sl = (UINT)(n >> (msb - SL_BITS)) - SL_COUNT;
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				tlsf_find
+*
+* Type:				Function
+*
+* Description:		a free block of at least n units, or NO_UNIT
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static ULONG tlsf_find(RNDESC *rn, ULONG n)
+
+{
+	UINT fl;
+	UINT sl;
+	ULONG map;
+	ULONG want;
+	ULONG u;
+
+	/*
+	 * round up to the next list boundary, so every block on the list
+	 * found fits without walking it
+	 */
+
+	want = n;
+
+	if (n >= SL_COUNT)
+	{
+		n += (1UL << (bit_high (n) - SL_BITS)) - 1;
+	}
+
+	tlsf_map (n, &fl, &sl);
+
+	map = 0;
+
+	if (fl < FL_COUNT)
+	{
+		if ((map = rn->slmap[fl] & (~0UL << sl)) == 0)
+		{
+			if ((fl + 1) < FL_COUNT)
+			{
+				if ((map = rn->flmap & (~0UL << (fl + 1))) != 0)
+				{
+					fl = bit_low (map);
+					map = rn->slmap[fl];
+				}
+			}
+		}
+	}
+
+	if (map != 0)
+	{
+		u = rn->free[fl][bit_low (map)];
+	}
+	else
+	{
+		/*
+		 * nothing bigger; the head of the list the size itself maps
+		 * to may still fit, which matters for a request near the
+		 * largest free block
+		 */
+
+		tlsf_map (want, &fl, &sl);
+
+		u = rn->free[fl][sl];
+
+		if ((u != NO_UNIT) && (TAG_SIZE (rn->tag[u]) < want))
+		{
+			u = NO_UNIT;
+		}
+	}
+
+	return (u);
+}
+
+/******************************************************************************
+*						  
+* Name:				list_insert
+*
+* Type:				Function
+*
+* Description:		put a free block on its list
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void list_insert(RNDESC *rn, ULONG u, ULONG n)
+
+{
+	UINT fl;
+	UINT sl;
+	ULONG next;
+
+	tlsf_map (n, &fl, &sl);
+
+	next = rn->free[fl][sl];
+
+	UNIT_NEXT (rn, u) = next;
+	UNIT_PREV (rn, u) = NO_UNIT;
+
+	if (next != NO_UNIT)
+	{
+		UNIT_PREV (rn, next) = u;
+	}
+
+	rn->free[fl][sl] = u;
+	rn->flmap |= (1UL << fl);
+	rn->slmap[fl] |= (1UL << sl);
+}
+
+/******************************************************************************
+*						  
+* Name:				list_remove
+*
+* Type:				Function
+*
+* Description:		take a free block off its list
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void list_remove(RNDESC *rn, ULONG u, ULONG n)
+
+{
+	UINT fl;
+	UINT sl;
+	ULONG next;
+	ULONG prev;
+
+	tlsf_map (n, &fl, &sl);
+
+	next = UNIT_NEXT (rn, u);
+	prev = UNIT_PREV (rn, u);
+
+	if (prev == NO_UNIT)
+	{
+		rn->free[fl][sl] = next;
+	}
+	else
+	{
+		UNIT_NEXT (rn, prev) = next;
+	}
+
+	if (next != NO_UNIT)
+	{
+		UNIT_PREV (rn, next) = prev;
+	}
+
+	if (rn->free[fl][sl] == NO_UNIT)
+	{
+		rn->slmap[fl] &= ~(1UL << sl);
+
+		if (rn->slmap[fl] == 0)
+		{
+			rn->flmap &= ~(1UL << fl);
+		}
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				blk_mark
+*
+* Type:				Function
+*
+* Description:		tag the first and last unit of a block
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void blk_mark(RNDESC *rn, ULONG u, ULONG n, ULONG free)
+
+{
+	rn->tag[u] = n | TAG_HEAD | free;
+
+	if (n > 1)
+	{
+		rn->tag[u + n - 1] = n | free;
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				blk_alloc
+*
+* Type:				Function
+*
+* Description:		allocate n units, splitting off the rest of the block
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static ULONG blk_alloc(RNDESC *rn, ULONG n)
+
+{
+	ULONG u;
+	ULONG size;
+
+	if ((u = tlsf_find (rn, n)) != NO_UNIT)
+	{
+		size = TAG_SIZE (rn->tag[u]);
+
+		list_remove (rn, u, size);
+
+		if (size > n)
+		{
+			blk_mark (rn, u + n, size - n, TAG_FREE);
+			list_insert (rn, u + n, size - n);
+		}
+
+		blk_mark (rn, u, n, 0);
+
+		rn->nfree -= n;
+	}
+
+	return (u);
+}
+
+/******************************************************************************
+*						  
+* Name:				blk_free
+*
+* Type:				Function
+*
+* Description:		free a block, merging it with free neighbours
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void blk_free(RNDESC *rn, ULONG u)
+
+{
+	ULONG n;
+	ULONG r;
+	ULONG rsize;
+	ULONG lsize;
+
+	n = TAG_SIZE (rn->tag[u]);
+
+	rn->nfree += n;
+
+	/*
+	 * the tags where two blocks meet become interior and are cleared;
+	 * blk_mark then rewrites the outer ones
+	 */
+
+	r = u + n;
+
+	if ((r < rn->units) && (rn->tag[r] & TAG_FREE))
+	{
+		rsize = TAG_SIZE (rn->tag[r]);
+
+		list_remove (rn, r, rsize);
+
+		rn->tag[u + n - 1] = 0;
+		rn->tag[r] = 0;
+
+		n += rsize;
+	}
+
+	if ((u > 0) && (rn->tag[u - 1] & TAG_FREE))
+	{
+		lsize = TAG_SIZE (rn->tag[u - 1]);
+
+		list_remove (rn, u - lsize, lsize);
+
+		rn->tag[u - 1] = 0;
+		rn->tag[u] = 0;
+
+		u -= lsize;
+		n += lsize;
+	}
+
+	blk_mark (rn, u, n, TAG_FREE);
+	list_insert (rn, u, n);
+}
+
+/******************************************************************************
+*						  
+* Name:				rn_serve
+*
+* Type:				Function
+*
+* Description:		hand freed memory to blocked rn_getseg callers
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void rn_serve(RNDESC *rn)
+
+{
+	UINT tid;
+	ULONG u;
+
+	/*
+	 * in queue order; the first waiter that does not fit stops the
+	 * scan, so a large request is not starved by smaller ones behind it
+	 */
+
+	while ((tid = rn->waitq.head) < MAX_TASK)
+	{
+		if ((u = blk_alloc (rn, RnWant[tid])) == NO_UNIT) break;
+
+		RnGot[tid] = UNIT_ADDR (rn, u);
+
+		gxk_t_wake (&rn->waitq, 0);
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				rn_create
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG rn_create(char name[4], void *saddr, ULONG length, ULONG unit_size,
+				ULONG flags, ULONG *rnid, ULONG *asiz)
+
+{
+	ULONG rtn;
+	ULONG inx;
+	ULONG units;
+	ULONG align;
+	UINT shift;
+	DWORD_PTR start;
+	DWORD_PTR end;
+	RNDESC *rn;
+
+	rtn = 0;
+	units = 0;
+	start = 0;
+
+	*rnid = MAX_REGION;
+	*asiz = 0;
+
+	for (shift = 0; ((1UL << shift) < unit_size) && (shift < 31); shift++)
+	{
+	}
+
+	if (((DWORD_PTR)saddr & (sizeof (ULONG) - 1)) != 0)
+	{
+		rtn = ERR_RNADDR;
+	}
+	else if ((unit_size < 16) || ((1UL << shift) != unit_size))
+	{
+		rtn = ERR_UNITSIZE;
+	}
+	else
+	{
+		/*
+		 * each unit costs its size plus a tag word; start from that
+		 * bound and give back what aligning the first unit takes
+		 */
+
+		align = (unit_size < CACHE_LINE) ? unit_size : CACHE_LINE;
+		end = (DWORD_PTR)saddr + length;
+
+		for (units = length / (unit_size + sizeof (ULONG)); units > 0; units--)
+		{
+			start = ((DWORD_PTR)saddr + (units * sizeof (ULONG)) + align - 1) & ~(DWORD_PTR)(align - 1);
+
+			if ((start <= end) && (((end - start) >> shift) >= units)) break;
+		}
+
+		if (units == 0)
+		{
+			rtn = ERR_TINYRN;
+		}
+		else if (units > TAG_SIZE (0xFFFFFFFF))
+		{
+			rtn = ERR_TINYUNIT;
+		}
+	}
+
+	if (rtn == 0)
+	{
+		gxk_k_lock ();
+
+		for (inx = 0; inx < MAX_REGION; inx++)
+		{
+			if (RnTbl[inx].name[0] == '\0') break;
+		}
+
+		if (inx == MAX_REGION)
+		{
+			rtn = ERR_OBJTFULL;
+		}
+		else
+		{
+			rn = &RnTbl[inx];
+
+			*rnid = inx;
+			*asiz = units << shift;
+
+			rn->name[0] = name[0];
+			rn->name[1] = name[1];
+			rn->name[2] = name[2];
+			rn->name[3] = name[3];
+
+			gxk_nm_add (NM_REGION, rn->name, inx);
+
+			rn->flags = flags;
+			rn->base = (char *)start;
+			rn->shift = shift;
+			rn->units = units;
+			rn->nfree = 0;
+			rn->tag = (ULONG *)saddr;
+			rn->flmap = 0;
+
+			for (inx = 0; inx < FL_COUNT; inx++)
+			{
+				rn->slmap[inx] = 0;
+
+				for (shift = 0; shift < SL_COUNT; shift++)
+				{
+					rn->free[inx][shift] = NO_UNIT;
+				}
+			}
+
+			for (inx = 0; inx < units; inx++)
+			{
+				rn->tag[inx] = 0;
+			}
+
+			gxk_t_initq (&rn->waitq, (flags & RN_PRIOR) != 0);
+
+			/*
+			 * the whole region starts as one allocated block given back
+			 */
+
+			blk_mark (rn, 0, units, 0);
+			blk_free (rn, 0);
+		}
+
+		gxk_k_leave ();
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				rn_delete
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG rn_delete(ULONG rnid)
+
+{
+	ULONG rtn;
+	RNDESC *rn;
+
+	rtn = 0;
+
+	if (rnid < MAX_REGION)
+	{
+		gxk_k_lock ();
+
+		rn = &RnTbl[rnid];
+
+		if (rn->name[0] == '\0')
+		{
+			rtn = ERR_OBJID;
+		}
+		else if (((rn->flags & RN_DEL) == 0) && (rn->nfree != rn->units))
+		{
+			rtn = ERR_SEGINUSE;
+		}
+		else
+		{
+			gxk_nm_remove (NM_REGION, rn->name, rnid);
+
+			rn->name[0] = '\0';
+
+			if (gxk_t_flush (&rn->waitq, ERR_RNKILLD) != 0)
+			{
+				rtn = ERR_TATRNDEL;
+			}
+		}
+
+		gxk_k_unlock ();
+	}
+	else
+	{
+		rtn = ERR_OBJID;
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				rn_getseg
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG rn_getseg(ULONG rnid, ULONG size, ULONG flags, ULONG timeout,
+				void **seg_addr)
+
+{
+	ULONG rtn;
+	ULONG n;
+	ULONG u;
+	UINT self;
+	RNDESC *rn;
+
+	rtn = 0;
+
+	*seg_addr = NULL;
+
+	if (rnid >= MAX_REGION)
+	{
+		return (ERR_OBJID);
+	}
+
+	rn = &RnTbl[rnid];
+
+	gxk_k_lock ();
+
+	n = (size >> rn->shift) + (((size & ((1UL << rn->shift) - 1)) != 0) ? 1 : 0);
+
+	if (rn->name[0] == '\0')
+	{
+		rtn = ERR_OBJID;
+	}
+	else if (size == 0)
+	{
+		rtn = ERR_ZERO;
+	}
+	else if (n > rn->units)
+	{
+		rtn = ERR_TOOBIG;
+	}
+	else if ((rn->waitq.head >= MAX_TASK) && ((u = blk_alloc (rn, n)) != NO_UNIT))
+	{
+		/*
+		 * earlier waiters are served first, so only try when none
+		 */
+
+		*seg_addr = UNIT_ADDR (rn, u);
+	}
+	else if (flags & RN_NOWAIT)
+	{
+		rtn = ERR_NOSEG;
+	}
+	else
+	{
+		self = gxk_t_self ();
+
+		if (self < MAX_TASK)
+		{
+			RnWant[self] = n;
+		}
+
+		if ((rtn = gxk_t_wait (&rn->waitq, gxk_tm_msec (timeout))) == 0)
+		{
+			*seg_addr = RnGot[self];
+		}
+		else if (rn->name[0] != '\0')
+		{
+			/* a head waiter giving up may have held back those behind it */
+			rn_serve (rn);
+		}
+
+		if (self < MAX_TASK)
+		{
+			RnWant[self] = 0;
+		}
+	}
+
+	gxk_k_unlock ();
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				rn_ident
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG rn_ident(char name[4], ULONG *rnid)
+
+{
+	ULONG rtn;
+
+	gxk_k_lock ();
+	rtn = gxk_nm_find (NM_REGION, name, rnid);
+	gxk_k_leave ();
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				rn_retseg
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG rn_retseg(ULONG rnid, void *seg_addr)
+
+{
+	ULONG rtn;
+	ULONG u;
+	DWORD_PTR off;
+	RNDESC *rn;
+
+	rtn = 0;
+
+	if (rnid >= MAX_REGION)
+	{
+		return (ERR_OBJID);
+	}
+
+	rn = &RnTbl[rnid];
+
+	gxk_k_lock ();
+
+	off = (DWORD_PTR)seg_addr - (DWORD_PTR)rn->base;
+	u = (ULONG)(off >> rn->shift);
+
+	if (rn->name[0] == '\0')
+	{
+		rtn = ERR_OBJID;
+	}
+	else if (((char *)seg_addr < rn->base) || ((off >> rn->shift) >= rn->units))
+	{
+		rtn = ERR_NOTINRN;
+	}
+	else if (((off & ((1UL << rn->shift) - 1)) != 0) || ((rn->tag[u] & TAG_HEAD) == 0))
+	{
+		rtn = ERR_SEGADDR;
+	}
+	else if (rn->tag[u] & TAG_FREE)
+	{
+		rtn = ERR_SEGFREE;
+	}
+	else
+	{
+		blk_free (rn, u);
+
+		rn_serve (rn);
+	}
+
+	/*
+	 * a served waiter that outranks the caller runs now
+	 */
+
+	gxk_k_unlock ();
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_rn_init
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_rn_init(void)
+
+{
+	UINT inx;
+
+	for (inx = 0; inx < MAX_REGION; inx++)
+	{
+		RnTbl[inx].name[0] = '\0';
+		gxk_t_initq (&RnTbl[inx].waitq, FALSE);
+	}
+
+	return (0);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_rn_purge
+*
+* Type:				Function
+*
+* Description:		serve rn_getseg waiters a deleted task was queued ahead of
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_rn_purge(ULONG tid)
+
+{
+	UINT inx;
+
+	/*
+	 * called with the kernel locked from task deletion and restart,
+	 * once the task is off its wait queue
+	 */
+
+	if (RnWant[tid] != 0)
+	{
+		RnWant[tid] = 0;
+
+		for (inx = 0; inx < MAX_REGION; inx++)
+		{
+			if (RnTbl[inx].name[0] != '\0')
+			{
+				rn_serve (&RnTbl[inx]);
+			}
+		}
+	}
+}
@@ -0,0 +1,561 @@
+/************************************BEGIN*****************************************
+*                       COPYRIGHT %G% %U% BY GHWORKS, LLC 
+*                             ALL RIGHTS RESERVED
+*                         SPDX-License-Identifier: MIT
+* ********************************************************************************
+* Name:        gxkSelect
+* Type:        C Source
+* File:        %M%
+* Version:     %I%
+* Description: Multiple Object Wait Services Interface
+*
+* Interface (public) Routines:
+*
+*	sl_wait
+*
+*	gxk_sl_init
+*	gxk_sl_post
+*	gxk_sl_purge
+*
+* Private Functions:
+*
+*	sl_enlist
+*	sl_match
+*	sl_poll
+*	sl_take
+*	sl_withdraw
+*
+* Modification History:
+* ----------------------------------------------------------- 
+* Date		Initials		Change Description
+* -----------------------------------------------------------
+* 10/14/26	GVH				Created
+*
+**************************************END***************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "gxkHost.h"
+#include "gxkernel.h"
+#include "gxkCfg.h"
+#include "gxkSys.h"
+
+/********************************
+		LOCAL DECLARATIONS
+********************************/
+
+/*
+ * sl_wait blocks in a kernel wait on no wait queue, as ev_receive
+ * does.  the entries are enlisted with their objects instead: each
+ * queue and semaphore counts the task among its waiters and
+ * selectors, and its events are marked as waited for.  whatever
+ * arrives first is taken for the task by gxk_sl_post, under the
+ * kernel lock, straight into its entry, and the whole set is
+ * withdrawn as the task is made ready, so nothing else is taken
+ */
+
+typedef struct
+{
+	struct slentry *set;			/* caller's set, NULL when not waiting */
+	ULONG n;						/* entries enlisted */
+	ULONG ready;					/* entry that ended the wait, n if none */
+	ULONG code;						/* 0, or the error it ended with */
+} SELDESC;
+
+/********************************
+		GLOBALS
+********************************/
+
+SELDESC SelTable[MAX_TASK];
+
+/******************************************************************************
+*						  
+* Name:				sl_take
+*
+* Type:				Function
+*
+* Description:		take what one entry waits for, if it is there
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static UINT sl_take(UINT tid, struct slentry *ent)
+
+{
+	UINT rtn;
+
+	switch (ent->type)
+	{
+	case SL_QUEUE:
+		rtn = (gxk_q_fetch (ent->id, ent->msg) != 0);
+		break;
+
+	case SL_SEM:
+		rtn = gxk_sem_take (ent->id);
+		break;
+
+	default:
+		rtn = ((ent->msg[0] = gxk_ev_take (tid, ent->id)) != 0);
+		break;
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				sl_poll
+*
+* Type:				Function
+*
+* Description:		first entry of a set that can be taken now
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static ULONG sl_poll(UINT tid, struct slentry *set, ULONG n)
+
+{
+	ULONG inx;
+
+	/*
+	 * the set is tried in order, so the caller ranks its objects
+	 */
+
+	for (inx = 0; inx < n; inx++)
+	{
+		if (sl_take (tid, &set[inx])) break;
+	}
+
+	return (inx);
+}
+
+/******************************************************************************
+*						  
+* Name:				sl_withdraw
+*
+* Type:				Function
+*
+* Description:		take a task's set off all its objects
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void sl_withdraw(UINT tid)
+
+{
+	ULONG inx;
+	SELDESC *sl;
+
+	sl = &SelTable[tid];
+
+	for (inx = 0; inx < sl->n; inx++)
+	{
+		switch (sl->set[inx].type)
+		{
+		case SL_QUEUE:
+			gxk_q_select (sl->set[inx].id, FALSE);
+			break;
+
+		case SL_SEM:
+			gxk_sem_select (sl->set[inx].id, FALSE);
+			break;
+
+		default:
+			gxk_ev_select (tid, FALSE);
+			break;
+		}
+	}
+
+	sl->set = NULL;
+	sl->n = 0;
+}
+
+/******************************************************************************
+*						  
+* Name:				sl_enlist
+*
+* Type:				Function
+*
+* Description:		put a task's set on all its objects
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static ULONG sl_enlist(UINT tid, struct slentry *set, ULONG n)
+
+{
+	ULONG rtn;
+	ULONG inx;
+	SELDESC *sl;
+
+	rtn = 0;
+	sl = &SelTable[tid];
+
+	sl->set = set;
+	sl->n = 0;
+	sl->ready = n;
+	sl->code = 0;
+
+	/*
+	 * n counts what is enlisted, so a bad entry withdraws the
+	 * ones before it
+	 */
+
+	for (inx = 0; (inx < n) && (rtn == 0); inx++)
+	{
+		switch (set[inx].type)
+		{
+		case SL_QUEUE:
+			rtn = gxk_q_select (set[inx].id, TRUE);
+			break;
+
+		case SL_SEM:
+			rtn = gxk_sem_select (set[inx].id, TRUE);
+			break;
+
+		case SL_EVENT:
+			gxk_ev_select (tid, TRUE);
+			break;
+
+		default:
+			rtn = ERR_OBJTYPE;
+			break;
+		}
+
+		if (rtn == 0)
+		{
+			sl->n++;
+		}
+	}
+
+	if (rtn != 0)
+	{
+		sl_withdraw (tid);
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				sl_match
+*
+* Type:				Function
+*
+* Description:		TRUE if an entry waits on the object posted
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static UINT sl_match(UINT tid, struct slentry *ent, UINT type, ULONG id)
+
+{
+	UINT rtn;
+
+	/*
+	 * an event post names the task, not the events
+	 */
+
+	if (ent->type != type)
+	{
+		rtn = FALSE;
+	}
+	else if (type == SL_EVENT)
+	{
+		rtn = (tid == id);
+	}
+	else
+	{
+		rtn = (ent->id == id);
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				sl_wait
+*
+* Type:				Function
+*
+* Description:		wait for the first of several queues, semaphores and events
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG sl_wait(struct slentry set[], ULONG n, ULONG flags, ULONG timeout, ULONG *ready)
+
+{
+	ULONG rtn;
+	ULONG inx;
+	UINT self;
+	DWORD msecTout;
+	SELDESC *sl;
+
+	rtn = 0;
+
+	self = gxk_t_self ();
+
+	if (self >= MAX_TASK)
+	{
+		rtn = ERR_OBJID;
+	}
+	else if ((n == 0) || (n > MAX_SELECT))
+	{
+		rtn = ERR_SELSIZE;
+	}
+	else
+	{
+		msecTout = gxk_tm_msec (timeout);
+
+		gxk_k_lock ();
+
+		sl = &SelTable[self];
+
+		/*
+		 * enlist before looking, so a post either finds the set or
+		 * left what it posted for this look to take
+		 */
+
+		if ((rtn = sl_enlist (self, set, n)) == 0)
+		{
+			if ((inx = sl_poll (self, set, n)) < n)
+			{
+				sl->ready = inx;
+			}
+			else if (flags & SL_NOWAIT)
+			{
+				rtn = ERR_NOSEL;
+			}
+			else
+			{
+				rtn = gxk_t_wait (NULL, msecTout);
+			}
+
+			/*
+			 * a post ending the wait has withdrawn the set already,
+			 * even one landing between a timeout and the relock
+			 */
+
+			if (sl->set != NULL)
+			{
+				sl_withdraw (self);
+			}
+
+			if (sl->ready < n)
+			{
+				*ready = sl->ready;
+				rtn = sl->code;
+			}
+		}
+
+		gxk_k_unlock ();
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_sl_post
+*
+* Type:				Function
+*
+* Description:		hand what arrived at an object to tasks waiting on it in sl_wait
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_sl_post(UINT type, ULONG id, ULONG code)
+
+{
+	ULONG count;
+	ULONG inx;
+	UINT tid;
+	SELDESC *sl;
+
+	/*
+	 * called with the kernel locked; returns the tasks made ready.
+	 * waiting tasks are served in task order, each taking what it
+	 * can until the object has nothing left
+	 */
+
+	count = 0;
+
+	for (tid = 0; tid < MAX_TASK; tid++)
+	{
+		sl = &SelTable[tid];
+
+		if (sl->set != NULL)
+		{
+			for (inx = 0; inx < sl->n; inx++)
+			{
+				if (sl_match (tid, &sl->set[inx], type, id) &&
+					((code != 0) || sl_take (tid, &sl->set[inx])))
+				{
+					sl->ready = inx;
+					sl->code = code;
+
+					sl_withdraw (tid);
+					gxk_t_ready (tid, code);
+
+					count++;
+					break;
+				}
+			}
+		}
+	}
+
+	return (count);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_sl_purge
+*
+* Type:				Function
+*
+* Description:		withdraw the set of a task being deleted
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_sl_purge(ULONG tid)
+
+{
+	/*
+	 * called with the kernel locked
+	 */
+
+	if (SelTable[tid].set != NULL)
+	{
+		sl_withdraw ((UINT)tid);
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_sl_init
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_sl_init(void)
+
+{
+	UINT inx;
+
+	for (inx = 0; inx < MAX_TASK; inx++)
+	{
+		SelTable[inx].set = NULL;
+		SelTable[inx].n = 0;
+		SelTable[inx].ready = 0;
+		SelTable[inx].code = 0;
+	}
+
+	return (0);
+}
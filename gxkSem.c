@@ -11,17 +11,25 @@
 *
 * Interface (public) Routines:
 *
+*	sm_av
 *	sm_create
 *	sm_delete
 *	sm_ident
+*	sm_info
 *	sm_p
 *	sm_v
 *
 *	gxk_sem_init
+*	gxk_sem_select
+*	gxk_sem_take
+*	gxk_sem_wake
 *
 * Private Functions:
 *
 *	gxkTmp
+*	sem_give
+*	sem_take
+*	sem_waited
 *
 * Modification History:
 * ----------------------------------------------------------- 
@@ -32,11 +40,11 @@
 **************************************END***************************************/
 
 #include <stdio.h>
-#include <windows.h>
 #include <stdlib.h>
-#include <process.h>
+#include "gxkHost.h"
 #include "gxkernel.h"
 #include "gxkCfg.h"
+#include "gxkSys.h"
 
 /********************************
 		LOCAL DECLARATIONS
@@ -44,10 +52,30 @@
 
 #define MAX_SEM_COUNT		8
 
+/*
+ * the count is taken and given with interlocked operations, so an
+ * uncontended sm_p / sm_v never enters the kernel.  a task that has
+ * to block first counts itself in waiters under the kernel lock;
+ * sm_v looks at waiters after banking its unit and, if set, takes
+ * the unit back to hand it to the first waiter.  each semaphore has a
+ * cache line to itself, so tasks hammering neighbours do not collide.
+ * the sm_info statistics are only kept on the slow path, under the
+ * kernel lock
+ */
+
 typedef struct
 {
+	CACHE_ALIGN volatile LONG count;
+	volatile LONG waiters;		/* tasks about to block or blocked */
+	ULONG selectors;			/* of those, tasks in sl_wait */
+	UINT used;
+	GXKWAITQ waitq;				/* tasks blocked in sm_p */
 	char name[4];
-	HANDLE gxkSid;
+	ULONG flags;
+	ULONG contended;			/* sm_p calls that found no unit */
+	ULONG blocked;				/* of those, the ones that waited */
+	ULONG timeouts;
+	ULONG whist[SM_WAITBINS];	/* waits by log2 ticks */
 } SEMDESC;
 
 /********************************
@@ -56,6 +84,190 @@ typedef struct
 
 SEMDESC SemTbl[MAX_SEM];
 
+/******************************************************************************
+*						  
+* Name:				sem_take
+*
+* Type:				Function
+*
+* Description:		take a unit if one is banked
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static UINT sem_take(SEMDESC *sem_p)
+
+{
+	LONG cnt;
+	UINT rtn;
+
+	rtn = FALSE;
+
+	while ((cnt = sem_p->count) > 0)
+	{
+		if (InterlockedCompareExchange (&sem_p->count, cnt - 1, cnt) == cnt)
+		{
+			rtn = TRUE;
+			break;
+		}
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				sem_give
+*
+* Type:				Function
+*
+* Description:		bank a unit, up to MAX_SEM_COUNT
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void sem_give(SEMDESC *sem_p)
+
+{
+	LONG cnt;
+
+	while ((cnt = sem_p->count) < MAX_SEM_COUNT)
+	{
+		if (InterlockedCompareExchange (&sem_p->count, cnt + 1, cnt) == cnt) break;
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				sem_waited
+*
+* Type:				Function
+*
+* Description:		add a finished wait to the statistics
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void sem_waited(SEMDESC *sem_p, ULONG ticks, ULONG rtn)
+
+{
+	UINT bin;
+
+	/*
+	 * bin 0 is under a tick, then 1, 2-3, 4-7 ... and the last bin
+	 * takes everything longer
+	 */
+
+	for (bin = 0; (ticks != 0) && (bin < SM_WAITBINS - 1); bin++)
+	{
+		ticks >>= 1;
+	}
+
+	sem_p->blocked++;
+	sem_p->whist[bin]++;
+
+	if (rtn == ERR_TIMEOUT)
+	{
+		sem_p->timeouts++;
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				sm_av
+*
+* Type:				Function
+*
+* Description:		sm_v from interrupt level
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG sm_av(ULONG smid)
+
+{
+	ULONG rtn;
+	GXKDEFER *defer;
+	SEMDESC *sem_p;
+
+	rtn = 0;
+
+	if (smid < MAX_SEM)
+	{
+		sem_p = &SemTbl[smid];
+
+		if (sem_p->used == FALSE)
+		{
+			rtn = ERR_OBJDEL;
+		}
+		else if ((defer = gxk_k_claim ()) == NULL)
+		{
+			rtn = ERR_ASFULL;
+		}
+		else
+		{
+			/*
+			 * bank the unit now; handing it to a waiter is left to
+			 * the kernel
+			 */
+
+			sem_give (sem_p);
+
+			gxk_k_post (defer, (sem_p->waiters != 0) ? DF_SEM : DF_NOP, smid);
+		}
+	}
+	else
+	{ 
+		rtn = ERR_OBJID;
+	}
+
+	return (rtn);
+}
+
 /******************************************************************************
 *						  
 * Name:				sm_create
@@ -83,13 +295,16 @@ ULONG sm_create(char name[4], ULONG count, ULONG flags, ULONG *smid)
 {
 	ULONG rtn;
 	ULONG inx;
+	UINT bin;
 	SEMDESC *sem_p;
 
 	inx = 0;
 	
+	gxk_k_lock ();
+
 	while (inx < MAX_SEM)
 	{
-		if (SemTbl[inx].gxkSid == NULL)
+		if (SemTbl[inx].used == FALSE)
 			break;
 		++inx;
 	}
@@ -102,18 +317,39 @@ ULONG sm_create(char name[4], ULONG count, ULONG flags, ULONG *smid)
 	{
 		sem_p = &SemTbl[inx];
 
-		sem_p->gxkSid = CreateSemaphore (NULL, count, MAX_SEM_COUNT, (LPCTSTR)name);
+		sem_p->used = TRUE;
+		sem_p->count = (count < MAX_SEM_COUNT) ? (LONG)count : MAX_SEM_COUNT;
+		sem_p->flags = flags;
+		sem_p->waiters = 0;
+		sem_p->selectors = 0;
+		gxk_t_initq (&sem_p->waitq, (flags & SM_PRIOR) != 0);
+
+		sem_p->contended = sem_p->blocked = sem_p->timeouts = 0;
+
+		for (bin = 0; bin < SM_WAITBINS; bin++)
+		{
+			sem_p->whist[bin] = 0;
+		}
 		
 		sem_p->name[0] = name[0];
 		sem_p->name[1] = name[1];
 		sem_p->name[2] = name[2];
 		sem_p->name[3] = name[3];
 		
+		gxk_nm_add (NM_SEM, sem_p->name, inx);
+
+		if (flags & SM_GLOBAL)
+		{
+			gxk_nd_export (NM_SEM, sem_p->name, inx);
+		}
+		
 		*smid = inx;
 		
 		rtn = 0;
 	}
 
+	gxk_k_leave ();
+
 	return (rtn);
 }
 
@@ -143,19 +379,46 @@ ULONG sm_delete(ULONG smid)
 
 {
 	ULONG rtn;
+	ULONG count;
 
 	if (smid < MAX_SEM)
 	{
-		if (SemTbl[smid].gxkSid != NULL)
+		gxk_k_lock ();
+
+		if (SemTbl[smid].used != FALSE)
 		{
-			SemTbl[smid].gxkSid = NULL;
+			gxk_nm_remove (NM_SEM, SemTbl[smid].name, smid);
+			gxk_nd_unexport (NM_SEM, smid);
+
+			SemTbl[smid].used = FALSE;
 			SemTbl[smid].name[0] = '\0';
-			rtn = 0;
+
+			/*
+			 * tasks still waiting get ERR_SKILLD
+			 */
+
+			count = gxk_t_flush (&SemTbl[smid].waitq, ERR_SKILLD);
+
+			if (SemTbl[smid].selectors != 0)
+			{
+				count += gxk_sl_post (SL_SEM, smid, ERR_SKILLD);
+			}
+
+			if (count != 0)
+			{
+				rtn = ERR_TATSDEL;
+			}
+			else
+			{
+				rtn = 0;
+			}
 		}
 		else
 		{
 			rtn = ERR_OBJDEL;
 		}
+
+		gxk_k_unlock ();
 	}
 	else
 	{ 
@@ -191,24 +454,72 @@ ULONG sm_ident(char name[4], ULONG node, ULONG *smid)
 
 {
 	ULONG rtn;
+
+	rtn = gxk_nd_ident (NM_SEM, name, node, smid);
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				sm_info
+*
+* Type:				Function
+*
+* Description:		snapshot the statistics of a semaphore
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG sm_info(ULONG smid, struct sminfo *info)
+
+{
+	ULONG rtn;
+	UINT bin;
 	SEMDESC *sem_p;
-	UINT inx;
 
-	rtn = ERR_OBJNF;
+	rtn = 0;
 
-	for (inx = 0; inx < MAX_SEM; inx++)
+	if (smid < MAX_SEM)
 	{
-		sem_p = &SemTbl[inx];
+		gxk_k_lock ();
+
+		sem_p = &SemTbl[smid];
 
-		if (sem_p->name[0] == name[0])
-			if (sem_p->name[1] == name[1])
-				if (sem_p->name[2] == name[2])
-					if (sem_p->name[3] == name[3])
-					{
-						rtn = 0;
-						*smid = inx;
-						break;
-					}
+		if (sem_p->used == FALSE)
+		{
+			rtn = ERR_OBJDEL;
+		}
+		else
+		{
+			info->count = (ULONG)sem_p->count;
+			info->contended = sem_p->contended;
+			info->blocked = sem_p->blocked;
+			info->timeouts = sem_p->timeouts;
+			info->waiting = (ULONG)sem_p->waiters;
+
+			for (bin = 0; bin < SM_WAITBINS; bin++)
+			{
+				info->wait_hist[bin] = sem_p->whist[bin];
+			}
+		}
+
+		gxk_k_leave ();
+	}
+	else
+	{
+		rtn = ERR_OBJID;
 	}
 
 	return (rtn);
@@ -240,28 +551,75 @@ ULONG sm_p(ULONG smid, ULONG flags, ULONG timeout)
 
 {
 	ULONG rtn;
+	ULONG spin;
+	ULONG start;
 	DWORD msecTout;
-	DWORD gxkrtn;
+	SEMDESC *sem_p;
 
 	rtn = 0;
 
 	if (smid < MAX_SEM)
 	{
-		if (SemTbl[smid].gxkSid != NULL)
+		sem_p = &SemTbl[smid];
+
+		if (sem_p->used == FALSE)
 		{
-			msecTout = (flags & SM_NOWAIT) ? 0 : (timeout * 10);
-			msecTout = (msecTout) ? msecTout : INFINITE;
+			rtn = ERR_OBJDEL;
+		}
+		else if (sem_take (sem_p))
+		{
+		}
+		else if (flags & SM_NOWAIT)
+		{
+			rtn = ERR_NOSEM;
+		}
+		else
+		{
+			/*
+			 * poll a while for a sm_v from another thread before
+			 * paying for a kernel wait
+			 */
+
+			for (spin = 0; spin < SEM_SPIN; spin++)
+			{
+				YieldProcessor ();
 			
-			gxkrtn = WaitForSingleObject (SemTbl[smid].gxkSid, msecTout);
+				if (sem_p->count > 0) break;
+			}
 
-			if (gxkrtn == WAIT_TIMEOUT)
+			gxk_k_lock ();
+
+			InterlockedIncrement (&sem_p->waiters);
+
+			if (sem_p->used == FALSE)
 			{
-				rtn = (flags & SM_NOWAIT) ? ERR_NOSEM : ERR_TIMEOUT;
+				rtn = ERR_OBJDEL;
 			}
-		}
-		else
-		{
-			rtn = ERR_OBJDEL;
+			else
+			{
+				sem_p->contended++;
+
+				if (sem_take (sem_p) == FALSE)
+				{
+					/*
+					 * block; sm_v hands its unit straight to the waiter
+					 */
+
+					msecTout = gxk_tm_msec (timeout);
+
+					GXK_TRACE (TR_SMBLOCK, smid, gxk_t_self (), 0);
+
+					start = gxk_tm_now ();
+
+					rtn = gxk_t_wait (&sem_p->waitq, msecTout);
+
+					sem_waited (sem_p, gxk_tm_now () - start, rtn);
+				}
+			}
+
+			InterlockedDecrement (&sem_p->waiters);
+
+			gxk_k_unlock ();
 		}
 	}
 	else
@@ -298,20 +656,42 @@ ULONG sm_v(ULONG smid)
 
 {
 	ULONG rtn;
+	SEMDESC *sem_p;
 
 	rtn = 0;
 
 	if (smid < MAX_SEM)
 	{
-		if (SemTbl[smid].gxkSid != NULL)
+		sem_p = &SemTbl[smid];
+
+		if (sem_p->used == FALSE)
 		{
-			ReleaseSemaphore (SemTbl[smid].gxkSid, 1, NULL); 
+			rtn = ERR_OBJDEL;
 		}
 		else
 		{
-			rtn = ERR_OBJDEL;
+			sem_give (sem_p);
+
+			if (sem_p->waiters != 0)
+			{
+				/*
+				 * a task may be blocked; unless a waiter already took
+				 * the unit, pass it to the first one.  leaving the
+				 * kernel preempts the caller if the waiter outranks it
+				 */
+
+				gxk_k_lock ();
+
+				gxk_sem_wake (smid);
+
+				gxk_k_unlock ();
+			}
 		}
 	}
+	else if (ND_NODE (smid) != 0)
+	{
+		rtn = gxk_nd_send (ND_SMV, smid, NULL);
+	}
 	else
 	{ 
 		rtn = ERR_OBJID;
@@ -350,8 +730,160 @@ ULONG gxk_sem_init (void)
 	for (inx = 0; inx < MAX_SEM; inx++)
 	{
 		SemTbl[inx].name[0] = '\0';
-		SemTbl[inx].gxkSid == NULL;
+		SemTbl[inx].count = 0;
+		SemTbl[inx].flags = 0;
+		SemTbl[inx].used = FALSE;
+		SemTbl[inx].waiters = 0;
+		SemTbl[inx].selectors = 0;
+		gxk_t_initq (&SemTbl[inx].waitq, FALSE);
 	}
 	
 	return (0);
 }
+
+/******************************************************************************
+*						  
+* Name:				gxk_sem_select
+*
+* Type:				Function
+*
+* Description:		count a task in sl_wait among a semaphore's waiters, or stop counting it
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_sem_select(ULONG smid, UINT on)
+
+{
+	ULONG rtn;
+	SEMDESC *sem_p;
+
+	rtn = 0;
+
+	/*
+	 * called with the kernel locked.  a waiter count makes sm_v
+	 * enter the kernel, where gxk_sem_wake finds the selector
+	 */
+
+	if (!on)
+	{
+		sem_p = &SemTbl[smid];
+
+		--sem_p->selectors;
+		InterlockedDecrement (&sem_p->waiters);
+	}
+	else if (smid >= MAX_SEM)
+	{
+		rtn = ERR_OBJID;
+	}
+	else if (SemTbl[smid].used == FALSE)
+	{
+		rtn = ERR_OBJDEL;
+	}
+	else
+	{
+		sem_p = &SemTbl[smid];
+
+		++sem_p->selectors;
+		InterlockedIncrement (&sem_p->waiters);
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_sem_take
+*
+* Type:				Function
+*
+* Description:		take a unit for a task waiting in sl_wait
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+UINT gxk_sem_take(ULONG smid)
+
+{
+	/*
+	 * called with the kernel locked
+	 */
+
+	return ((SemTbl[smid].used) && (sem_take (&SemTbl[smid])));
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_sem_wake
+*
+* Type:				Function
+*
+* Description:		pass a banked unit to the first waiter
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_sem_wake(ULONG smid)
+
+{
+	UINT tid;
+	SEMDESC *sem_p;
+
+	/*
+	 * called with the kernel locked; unless a waiter already took
+	 * the unit, it is taken back and handed over
+	 */
+
+	sem_p = &SemTbl[smid];
+
+	if ((sem_p->used) && (sem_take (sem_p)))
+	{
+		if ((tid = gxk_t_wake (&sem_p->waitq, 0)) == MAX_TASK)
+		{
+			/* no task blocked in sm_p; an sl_wait may take it */
+			sem_give (sem_p);
+
+			if (sem_p->selectors != 0)
+			{
+				gxk_sl_post (SL_SEM, smid, 0);
+			}
+		}
+		else
+		{
+			GXK_TRACE (TR_SMWAKE, smid, tid, 0);
+		}
+	}
+}
@@ -0,0 +1,350 @@
+/************************************BEGIN*****************************************
+*                       COPYRIGHT %G% %U% BY GHWORKS, LLC 
+*                             ALL RIGHTS RESERVED
+*                         SPDX-License-Identifier: MIT
+* ********************************************************************************
+* Name:        gxkSignal
+* Type:        C Source
+* File:        %M%
+* Version:     %I%
+* Description: Asynchronous Signal Services Interface
+*
+* Interface (public) Routines:
+*
+*	as_catch
+*	as_return
+*	as_send
+*
+*	gxk_as_init
+*	gxk_as_purge
+*	gxk_as_run
+*
+* Modification History:
+* ----------------------------------------------------------- 
+* Date		Initials		Change Description
+* -----------------------------------------------------------
+* 10/14/26	GVH				Created
+*
+**************************************END***************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "gxkHost.h"
+#include <setjmp.h>
+#include "gxkernel.h"
+#include "gxkCfg.h"
+#include "gxkSys.h"
+
+/********************************
+		LOCAL DECLARATIONS
+********************************/
+
+/*
+ * as_send only ors the signals into the target's pending mask, so it
+ * never takes the kernel lock.  the target runs its ASR itself, in
+ * gxk_as_run, on its way out of the kernel: after any service it
+ * calls and when it wakes from a kernel wait.  the ASR is entered
+ * with the mode given to as_catch and leaves by as_return, which
+ * jumps back to gxk_as_run to put the task's own mode back
+ */
+
+#define AS_MODES			(T_NOPREEMPT | T_TSLICE | T_NOASR | T_NOISR)
+
+typedef struct
+{
+	void (*asr)();				/* NULL when the task has no ASR */
+	ULONG mode;					/* mode the ASR runs in */
+	volatile LONG pend;			/* signals sent, not yet taken */
+	UINT inasr;					/* ASR running */
+	jmp_buf ret;				/* as_return's way back */
+} SIGDESC;
+
+/********************************
+		GLOBALS
+********************************/
+
+SIGDESC SigTable[MAX_TASK];
+
+/******************************************************************************
+*						  
+* Name:				as_catch
+*
+* Type:				Function
+*
+* Description:		set up, or with a NULL start_addr remove, the task's ASR
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG as_catch(void (*start_addr)(), ULONG mode)
+
+{
+	ULONG rtn;
+	UINT self;
+
+	rtn = 0;
+
+	self = gxk_t_self ();
+
+	if (self >= MAX_TASK)
+	{
+		rtn = ERR_OBJID;
+	}
+	else
+	{
+		SigTable[self].mode = mode;
+		SigTable[self].asr = start_addr;
+
+		/* signals sent to the old ASR are not given to a new one */
+		InterlockedExchange (&SigTable[self].pend, 0);
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				as_return
+*
+* Type:				Function
+*
+* Description:		leave the ASR and resume the task where it was
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG as_return(void)
+
+{
+	ULONG rtn;
+	UINT self;
+
+	rtn = 0;
+
+	self = gxk_t_self ();
+
+	if ((self >= MAX_TASK) || (!SigTable[self].inasr))
+	{
+		rtn = ERR_NOTINASR;
+	}
+	else
+	{
+		longjmp (SigTable[self].ret, 1);
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				as_send
+*
+* Type:				Function
+*
+* Description:		send signals to a task's ASR
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG as_send(ULONG tid, ULONG signals)
+
+{
+	ULONG rtn;
+
+	rtn = 0;
+
+	if (tid >= MAX_TASK)
+	{
+		rtn = ERR_OBJID;
+	}
+	else if (SigTable[tid].asr == NULL)
+	{
+		rtn = ERR_NOASR;
+	}
+	else
+	{
+		InterlockedOr (&SigTable[tid].pend, (LONG)signals);
+
+		/* a task signalling itself takes them now */
+		if (tid == gxk_t_self ())
+		{
+			gxk_as_run ();
+		}
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_as_run
+*
+* Type:				Function
+*
+* Description:		run the calling task's ASR for the signals pending
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_as_run(void)
+
+{
+	UINT self;
+	ULONG mode;
+	ULONG sigs;
+	SIGDESC *sg;
+
+	/*
+	 * called with the kernel unlocked, on every kernel exit, so the
+	 * common case of no signals is a single look at the mask.  the
+	 * ASR is not entered again while it runs; signals sent meanwhile
+	 * run it once more when it returns
+	 */
+
+	self = gxk_t_self ();
+
+	if (self >= MAX_TASK)
+	{
+		return;
+	}
+
+	sg = &SigTable[self];
+
+	if ((sg->pend == 0) || (sg->inasr) || (sg->asr == NULL) ||
+		(gxk_t_mode (self) & T_NOASR))
+	{
+		return;
+	}
+
+	sg->inasr = TRUE;
+
+	t_mode (AS_MODES, sg->mode, &mode);
+
+	while ((sg->asr != NULL) && ((sigs = (ULONG)InterlockedExchange (&sg->pend, 0)) != 0))
+	{
+		if (setjmp (sg->ret) == 0)
+		{
+			((void (*)(ULONG))sg->asr) (sigs);
+		}
+	}
+
+	t_mode (AS_MODES, mode, &mode);
+
+	sg->inasr = FALSE;
+
+	/* signals let in by the task's own mode */
+	if (sg->pend != 0)
+	{
+		gxk_as_run ();
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_as_purge
+*
+* Type:				Function
+*
+* Description:		drop the ASR and signals of a task being deleted
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_as_purge(ULONG tid)
+
+{
+	SigTable[tid].asr = NULL;
+	SigTable[tid].mode = 0;
+	SigTable[tid].pend = 0;
+	SigTable[tid].inasr = FALSE;
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_as_init
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_as_init(void)
+
+{
+	UINT inx;
+
+	for (inx = 0; inx < MAX_TASK; inx++)
+	{
+		gxk_as_purge (inx);
+	}
+
+	return (0);
+}
@@ -26,9 +26,8 @@
 **************************************END***************************************/
 
 #include <stdio.h>
-#include <windows.h>
 #include <stdlib.h>
-#include <process.h>
+#include "gxkHost.h"
 #include "gxkernel.h"
 #include "gxkSys.h"
 
@@ -57,10 +56,20 @@
 ULONG gxkInit ()
 
 {
+	gxk_k_init();
+	gxk_nm_init();
 	gxk_t_init();
 	gxk_ev_init();
 	gxk_sem_init();
+	gxk_mu_init();
 	gxk_q_init();
+	gxk_tm_init();
+	gxk_pt_init();
+	gxk_rn_init();
+	gxk_de_init();
+	gxk_sl_init();
+	gxk_as_init();
+	gxk_nd_init();
 
 	return (0);
 }
@@ -27,3 +27,218 @@ ULONG gxk_t_init(void);
 ULONG gxk_ev_init(void);
 ULONG gxk_sem_init(void);
 ULONG gxk_q_init(void);
+ULONG gxk_nm_init(void);
+ULONG gxk_tm_init(void);
+ULONG gxk_pt_init(void);
+ULONG gxk_rn_init(void);
+ULONG gxk_mu_init(void);
+ULONG gxk_de_init(void);
+ULONG gxk_sl_init(void);
+ULONG gxk_as_init(void);
+ULONG gxk_nd_init(void);
+ULONG gxk_k_init(void);
+
+/*
+ * tables written from several cores keep each object on cache lines
+ * of its own
+ */
+
+#define CACHE_LINE			64
+
+#if defined(__GNUC__)
+#define CACHE_ALIGN			__attribute__((aligned(CACHE_LINE)))
+#else
+#define CACHE_ALIGN			__declspec(align(64))
+#endif
+
+/*
+ * kernel lock and dispatch (gxkKernel.c, gxkTask.c)
+ *
+ * every kernel service that touches scheduling state runs between
+ * gxk_k_lock and gxk_k_unlock; gxk_k_unlock is the kernel exit point
+ * and hands the CPU to a higher priority task made ready in between
+ */
+
+#define MIN_PRIO			1				/* task priorities */
+#define MAX_PRIO			256
+
+typedef struct
+{
+	UINT head;
+	UINT tail;
+	UINT prior;					/* TRUE: ordered by task priority */
+} GXKWAITQ;
+
+void gxk_k_lock(void);
+void gxk_k_unlock(void);
+void gxk_k_leave(void);
+
+/*
+ * deferred work (gxkKernel.c)
+ *
+ * the asynchronous calls ev_asend, sm_av, q_asend, q_avsend and
+ * q_aurgent may run where the kernel lock cannot be taken.  each
+ * claims a slot first, so it either completes or fails with
+ * ERR_ASFULL having done nothing, then does its lock-free part and
+ * posts the rest; the kernel runs posted work, under its lock, on
+ * the next gxk_k_unlock, clock tick or i_return
+ */
+
+#define DF_NOP			0			/* deferred work */
+#define DF_EVENT		1			/* gxk_ev_post (id, 0) */
+#define DF_SEM			2			/* gxk_sem_wake (id) */
+#define DF_QWAKE		3			/* gxk_q_wake (id, arg[0]) */
+#define DF_QURGENT		4			/* gxk_q_push (id, arg) */
+
+typedef struct
+{
+	volatile LONG seq;			/* ring turn of this slot */
+	LONG pos;					/* position it was claimed for */
+	UINT op;
+	ULONG id;
+	ULONG arg[4];
+} GXKDEFER;
+
+GXKDEFER *gxk_k_claim(void);
+void gxk_k_post(GXKDEFER *slot, UINT op, ULONG id);
+
+/*
+ * kernel tracing (gxkKernel.c)
+ *
+ * with TRACE_EVENTS set, GXK_TRACE stamps a TR_* record into the
+ * calling core's trace ring for k_trace to drain; it never blocks
+ * and never takes the kernel lock.  otherwise it compiles to nothing
+ */
+
+#if TRACE_EVENTS
+#define GXK_TRACE(ev, id, a0, a1)	gxk_k_trace ((ev), (ULONG)(id), (ULONG)(a0), (ULONG)(a1))
+#else
+#define GXK_TRACE(ev, id, a0, a1)
+#endif
+
+void gxk_k_trace(UINT event, ULONG id, ULONG arg0, ULONG arg1);
+
+ULONG gxk_t_getTid(unsigned threadid, ULONG *tid);
+UINT gxk_t_self(void);
+ULONG gxk_t_sched(void);
+void gxk_t_park(ULONG msec);
+void gxk_t_initq(GXKWAITQ *wq, UINT prior);
+ULONG gxk_t_wait(GXKWAITQ *wq, ULONG msec);
+void gxk_t_ready(UINT tid, ULONG code);
+UINT gxk_t_wake(GXKWAITQ *wq, ULONG code);
+ULONG gxk_t_flush(GXKWAITQ *wq, ULONG code);
+ULONG gxk_t_delay(ULONG msec);
+void gxk_t_setprio(UINT tid, ULONG prio);
+ULONG gxk_t_base(UINT tid);
+ULONG gxk_t_prio(UINT tid);
+ULONG gxk_t_mode(UINT tid);
+ULONG gxk_t_release(UINT tid, ULONG *release);
+UINT gxk_t_tick(void);
+
+/*
+ * object name registry (gxkName.c); callers hold the kernel lock
+ */
+
+#define NM_TASK			0			/* object classes */
+#define NM_QUEUE		1
+#define NM_SEM			2
+#define NM_PART			3
+#define NM_REGION		4
+#define NM_VQUEUE		5
+#define NM_MUTEX		6
+#define NM_CLASSES		7
+
+void gxk_nm_add(UINT cls, char name[4], ULONG id);
+void gxk_nm_remove(UINT cls, char name[4], ULONG id);
+ULONG gxk_nm_find(UINT cls, char name[4], ULONG *id);
+
+/*
+ * event, timer and partition services for callers holding the
+ * kernel lock (gxkEvent.c, gxkTime.c, gxkPart.c)
+ */
+
+void gxk_ev_post(ULONG tid, ULONG events);
+ULONG gxk_ev_take(ULONG tid, ULONG events);
+void gxk_ev_select(ULONG tid, UINT on);
+void gxk_tm_purge(ULONG tid);
+void gxk_pt_purge(ULONG tid);
+void gxk_rn_purge(ULONG tid);
+ULONG gxk_tm_msec(ULONG ticks);
+ULONG gxk_tm_now(void);
+void gxk_tm_slice(void);
+void gxk_tm_batch(void);
+
+/*
+ * semaphore and queue wakeups for callers holding the kernel lock
+ * (gxkSem.c, gxkQueue.c)
+ */
+
+void gxk_sem_wake(ULONG smid);
+UINT gxk_sem_take(ULONG smid);
+ULONG gxk_sem_select(ULONG smid, UINT on);
+void gxk_q_wake(ULONG qid, ULONG cnt);
+ULONG gxk_q_push(ULONG qid, ULONG msg_buf[4]);
+ULONG gxk_q_fetch(ULONG qid, ULONG msg_buf[4]);
+ULONG gxk_q_select(ULONG qid, UINT on);
+
+/*
+ * multiple object waits (gxkSelect.c)
+ *
+ * a task blocked in sl_wait counts among the waiters of each queue
+ * and semaphore in its set, so their senders enter the kernel, and
+ * has its events marked as waited for.  the wake paths then call
+ * gxk_sl_post, which takes what arrived on the task's behalf; a
+ * nonzero code instead wakes it with that code, for a deleted
+ * object.  callers hold the kernel lock
+ */
+
+ULONG gxk_sl_post(UINT type, ULONG id, ULONG code);
+void gxk_sl_purge(ULONG tid);
+
+/*
+ * asynchronous signals (gxkSignal.c)
+ *
+ * gxk_k_unlock calls gxk_as_run, with the kernel unlocked, as the
+ * outermost kernel exit of a task; it runs the task's ASR if signals
+ * are pending and T_NOASR is clear.  gxk_as_purge is called with the
+ * kernel locked
+ */
+
+void gxk_as_run(void);
+void gxk_as_purge(ULONG tid);
+
+/*
+ * nodes (gxkNode.c)
+ *
+ * the upper half of an object id names the node it lives on, 0 for
+ * this one.  q_send, q_urgent, sm_v and ev_send hand a remote id to
+ * gxk_nd_send, which batches the call into that node's next frame;
+ * gxk_nd_flush, from the clock tick, sends frames left part full.
+ * *_ident resolves through gxk_nd_ident, which asks the other nodes
+ * for a global object not found here.  objects created global are
+ * entered with gxk_nd_export and withdrawn with gxk_nd_unexport,
+ * with the kernel locked; the others are called with it unlocked
+ */
+
+#define ND_NODE(id)			((id) >> 16)
+#define ND_INDEX(id)		((id) & 0xFFFF)
+#define ND_ID(node, inx)	(((ULONG)(node) << 16) | (inx))
+
+#define ND_QSEND		1			/* remote calls */
+#define ND_QURGENT		2
+#define ND_SMV			3
+#define ND_EVSEND		4
+
+ULONG gxk_nd_send(UINT op, ULONG id, ULONG arg[4]);
+ULONG gxk_nd_ident(UINT cls, char name[4], ULONG node, ULONG *id);
+void gxk_nd_export(UINT cls, char name[4], ULONG id);
+void gxk_nd_unexport(UINT cls, ULONG id);
+void gxk_nd_flush(void);
+
+/*
+ * mutex priority inheritance (gxkMutex.c); callers hold the kernel
+ * lock
+ */
+
+ULONG gxk_mu_ceiling(UINT tid);
+void gxk_mu_purge(ULONG tid);
@@ -15,21 +15,65 @@
 *	t_delete
 *	t_getreg
 *	t_ident
+*	t_info
 *	t_mode
 *	t_restart
 *	t_resume
+*	t_setaffinity
+*	t_setperiod
 *	t_setpri
 *	t_setreg
 *	t_start
 *	t_suspend
 *
+*	gxk_t_base
+*	gxk_t_delay
+*	gxk_t_flush
 *	gxk_t_getHandle
 *	gxk_t_getTid
 *	gxk_t_init
+*	gxk_t_initq
+*	gxk_t_mode
+*	gxk_t_park
+*	gxk_t_prio
+*	gxk_t_ready
+*	gxk_t_release
+*	gxk_t_sched
+*	gxk_t_setprio
+*	gxk_t_self
+*	gxk_t_tick
+*	gxk_t_wait
+*	gxk_t_wake
 *
 * Private Functions:
 *
 *	clear_gxktcb
+*	core_movable
+*	core_place
+*	core_running
+*	core_steal
+*	edf_before
+*	edf_pull
+*	edf_push
+*	edf_sift
+*	msb32
+*	ready_highest
+*	ready_insert
+*	ready_remove
+*	sched_admit
+*	sched_charge
+*	sched_rm
+*	start_task
+*	start_thread
+*	stop_task
+*	stop_thread
+*	waitq_insert
+*	waitq_remove
+*	worker_get
+*	worker_lose
+*	worker_main
+*	worker_put
+*	worker_spawn
 *
 * Modification History:
 * ----------------------------------------------------------- 
@@ -40,42 +84,171 @@
 **************************************END***************************************/
 
 #include <stdio.h>
-#include <windows.h>
 #include <stdlib.h>
-#include <process.h>
+#include "gxkHost.h"
+#include <setjmp.h>
 #include "gxkernel.h"
 #include "gxkCfg.h"
+#include "gxkSys.h"
 
 /********************************
 		LOCAL DECLARATIONS
 ********************************/
 
-#define MIN_PRIO			1
-#define MAX_PRIO			256
+
+#define PRIO_WORDS			(MAX_PRIO / 32)		/* ready bitmap words */
 
 #define REG_CNT				7
 
 #define TS_DEAD				0					/* task states */
 #define TS_CREATED			1
-#define TS_RUNNING			2
+#define TS_RUNNING			2					/* ready or running */
 #define TS_SUSPEND			3
+#define TS_BLOCKED			4					/* waiting in the kernel */
+
+#if defined(__GNUC__)
+#define THREAD_LOCAL		__thread
+#else
+#define THREAD_LOCAL		__declspec(thread)
+#endif
+
+/*
+ * every core has its own current task and priority run queue; a task
+ * is queued on one core of its affinity and, unless CORE_STEAL is 0,
+ * a core whose best ready task is weaker takes over a stronger one
+ * still waiting on another core.  core n is the host processor n
+ */
+
+#if (NUM_CORES < 1) || (NUM_CORES > 16)
+#error NUM_CORES must be 1 to 16
+#endif
+
+#define CORE_ALL			((1U << NUM_CORES) - 1)
+
+/*
+ * periodic tasks declared with t_setperiod are scheduled by
+ * SCHED_POLICY.  under rate monotonic each gets a priority at or
+ * below PERIOD_PRIO, shorter periods higher.  under earliest deadline
+ * first they all run at PERIOD_PRIO, and a ready one is kept on its
+ * core's deadline heap instead of the PERIOD_PRIO ready list; the
+ * heap's earliest deadline is dispatched ahead of that list.
+ * t_setperiod admits a task only if the periodic set still passes
+ * the policy's utilization test on one core
+ */
+
+#define SCHED_FIXED			0					/* SCHED_POLICY values */
+#define SCHED_RM			1
+#define SCHED_EDF			2
+
+#define EDF_LVL				(PERIOD_PRIO - 1)	/* ready level of the heap */
+#define NO_HEAP				MAX_TASK
+
+#if (PERIOD_PRIO < MIN_PRIO) || (PERIOD_PRIO > MAX_PRIO)
+#error PERIOD_PRIO must be a task priority
+#endif
+
+typedef struct
+{
+	CACHE_ALIGN UINT current;		/* running task, MAX_TASK when idle */
+	UINT group;						/* ready bitmap words in use */
+	UINT map[PRIO_WORDS];
+	UINT head[MAX_PRIO];
+	UINT tail[MAX_PRIO];
+	UINT nedf;						/* tasks on the deadline heap */
+	UINT edf[MAX_TASK];				/* deadline heap, earliest first */
+} GXKCORE;
+
+/*
+ * tasks run on pooled worker threads.  t_start hands the task to a
+ * parked worker whose stack is large enough, and a task that ends,
+ * is deleted or restarts sends its worker back to the pool rather
+ * than ending the thread.  there are spare slots beyond MAX_TASK for
+ * workers still on their way back
+ */
+
+#define MAX_WORKER			(2 * MAX_TASK)
+
+typedef struct
+{
+	GXKTHREAD thread;				/* NULL = no thread in the slot */
+	unsigned threadid;
+	GXKEVENT wake;					/* hands the worker a task */
+	GXKEVENT gate;					/* dispatch gate of the task served */
+	ULONG stack;
+	UINT tid;						/* task served, MAX_TASK when pooled */
+	UINT recall;					/* task deleted while parked */
+	UINT core;						/* core the thread is bound to */
+	UINT next;						/* pool link */
+	jmp_buf home;					/* worker_main, between tasks */
+} GXKWORKER;
+
+static unsigned HOST_CALL worker_main(void *arg);
+
+/*
+ * task state is split by use.  what dispatch and the kernel waits
+ * touch is kept in TaskList, in entries of TCB_LINES whole cache
+ * lines, so cores switching different tasks do not share lines;
+ * the thread ids gxk_t_getTid scans are packed in TaskThread, and
+ * what only create, start and the register calls use is kept apart
+ * in TaskMeta
+ */
+
+#define TCB_LINES			2				/* cache lines per TaskList entry */
+
+/*
+ * wide fields lead each line so an LP64 entry has no padding to push
+ * it onto a third line: the first holds what dispatch and the waits
+ * read, the second the scheduling and accounting state
+ */
+
+typedef struct
+{
+	CACHE_ALIGN ULONG prio;
+	ULONG mode;
+	GXKWAITQ *waitq;				/* wait queue blocked on, if any */
+	ULONG wcode;					/* wait completion code */
+	UINT state;
+	UINT next;						/* ready queue links */
+	UINT prev;
+	UINT wnext;						/* wait queue links */
+	UINT wprev;
+	UINT pend;						/* blocked in a kernel wait */
+	UINT body;						/* thread in the task body, not parked */
+	UINT preempted;					/* lost the CPU there, not parked yet */
+
+	ULONG deadline;					/* absolute tick of this job's deadline */
+	ULONG switches;					/* times dispatched, for t_info */
+	LONGLONG since;					/* counter when last dispatched */
+	LONGLONG run;					/* counts spent dispatched */
+	UINT worker;					/* pool thread serving the task */
+	UINT affinity;					/* cores the task may run on */
+	UINT core;						/* core whose run queue it is on */
+	UINT edf;						/* periodic under SCHED_EDF */
+	UINT hpos;						/* deadline heap slot, NO_HEAP if none */
+	UINT slice;						/* ticks left of a T_TSLICE quantum */
+} GXKTCB;
+
+/* fails to compile if an entry outgrows TCB_LINES or is not whole lines */
+typedef char GXKTCB_SIZE[((sizeof (GXKTCB) % CACHE_LINE) == 0) && (sizeof (GXKTCB) <= TCB_LINES * CACHE_LINE) ? 1 : -1];
 
 typedef struct
 {
 	char name[4];
-	ULONG prio;
 	ULONG sstacksize;
 	ULONG ustacksize;
 	ULONG flags;
 	ULONG reg[REG_CNT];
-	ULONG mode;
 	void *start_addr;
-	
-	HANDLE w32id;
-	unsigned threadid;
-
-	UINT state;
-} GXKTCB;
+	ULONG targs[4];
+	GXKTHREAD thread;
+	GXKEVENT gate;					/* dispatch gate of adopted threads */
+	ULONG bprio;					/* priority without inheritance */
+	ULONG period;					/* ticks, 0 = not periodic */
+	ULONG drel;						/* deadline, ticks after release */
+	ULONG cost;						/* worst case ticks per job */
+	ULONG release;					/* tick this job was released */
+	ULONG pprio;					/* bprio before it became periodic */
+} GXKTMETA;
 
 /********************************
 		GLOBALS
@@ -84,7 +257,28 @@ typedef struct
 ULONG TotalTaskCount;
 ULONG TotalStackUsed;
 GXKTCB TaskList[MAX_TASK];
-ULONG CurrentTask;
+GXKTMETA TaskMeta[MAX_TASK];
+unsigned TaskThread[MAX_TASK];
+
+GXKWORKER Workers[MAX_WORKER];
+UINT WorkerFree;
+
+/*
+ * run queues, one per core: a FIFO per priority level plus a two
+ * level bitmap, group has a bit per non-empty map word.  new tasks
+ * are dealt round the cores from NextCore
+ */
+
+GXKCORE Cores[NUM_CORES];
+UINT NextCore;
+
+/*
+ * task id and pool worker of the calling thread, set by worker_main
+ * before the task body runs; threads that are not tasks see MAX_TASK
+ */
+
+static THREAD_LOCAL UINT SelfTask = MAX_TASK;
+static THREAD_LOCAL GXKWORKER *SelfWorker = NULL;
 
 /******************************************************************************
 *						  
@@ -113,28 +307,50 @@ ULONG clear_gxktcb(ULONG tid)
 {
 	UINT inx;
 	GXKTCB *tcb_p;
+	GXKTMETA *meta_p;
 	
 	if (tid < MAX_TASK)
 	{
 		tcb_p = &TaskList[tid];
+		meta_p = &TaskMeta[tid];
 
-		tcb_p->name[0] = '\0';
+		meta_p->name[0] = '\0';
 		tcb_p->prio = 0;
-		tcb_p->sstacksize = 0;
-		tcb_p->ustacksize = 0;
-		tcb_p->flags = 0;
+		meta_p->bprio = 0;
+		meta_p->sstacksize = 0;
+		meta_p->ustacksize = 0;
+		meta_p->flags = 0;
+		meta_p->period = 0;
 
 		for (inx = 0; inx < REG_CNT; inx++)
 		{
-			tcb_p->reg[inx] = 0;
+			meta_p->reg[inx] = 0;
 		}
 		
 		tcb_p->mode = 0;
-		tcb_p->start_addr = NULL;
-		tcb_p->w32id = 0;
-		tcb_p->threadid = 0;
+		meta_p->start_addr = NULL;
+		meta_p->thread = NULL;
+		TaskThread[tid] = 0;
 
 		tcb_p->state = TS_DEAD;
+
+		/*
+		 * the dispatch gate belongs to the slot and is kept
+		 */
+
+		tcb_p->next = tcb_p->prev = MAX_TASK;
+		tcb_p->wnext = tcb_p->wprev = MAX_TASK;
+		tcb_p->waitq = NULL;
+		tcb_p->pend = FALSE;
+		tcb_p->wcode = 0;
+		tcb_p->body = FALSE;
+		tcb_p->preempted = FALSE;
+		tcb_p->worker = MAX_WORKER;
+		tcb_p->affinity = CORE_ALL;
+		tcb_p->core = 0;
+		tcb_p->edf = FALSE;
+		tcb_p->hpos = NO_HEAP;
+		tcb_p->slice = 0;
 	}
 
 	return (0);
@@ -142,11 +358,11 @@ ULONG clear_gxktcb(ULONG tid)
 
 /******************************************************************************
 *						  
-* Name:				t_create
+* Name:				msb32
 *
 * Type:				Function
 *
-* Description:		
+* Description:		index of the most significant set bit of a non-zero word
 * 
 * Formal Inputs:	
 *
@@ -161,86 +377,56 @@ ULONG clear_gxktcb(ULONG tid)
 * Author:			GVH
 *
 ******************************************************************************/
-		  
-ULONG t_create(char name[4], ULONG prio, ULONG sstack, ULONG ustack, ULONG flags, ULONG *tid)
-
-{
-	ULONG rtn;
-	UINT inx;
-	GXKTCB *tcb_p;
-	
-	if (TotalTaskCount < MAX_TASK)
-	{
-		if ((sstack < MIN_TSTACK) && (ustack < MIN_TSTACK))
-		{
-			rtn = ERR_TINYSTK;
-		}
-		else if ((sstack + ustack + TotalStackUsed) > MAX_SSTACK)
-		{
-			rtn = ERR_NOSTK;
-		}
-		else if ((prio < MIN_PRIO) || (prio > MAX_PRIO))
-		{
-			rtn = ERR_PRIOR;
-		}
-		else
-		{
-			/*
-			 * all parameters check OK - setup global data
-			 */
 
-			TotalStackUsed += sstack + ustack;
-
-			for (inx = 0; inx < MAX_TASK; inx++)
-			{
-				tcb_p = &TaskList[inx];
+static UINT msb32(UINT word)
 
-				if (tcb_p->state == TS_DEAD)
-				{
-					/*
-					 * initialize the task control block
-					 */
-					
-					tcb_p->name[0] = name[0];
-					tcb_p->name[1] = name[1];
-					tcb_p->name[2] = name[2];
-					tcb_p->name[3] = name[3];
-					tcb_p->prio = prio;
-					tcb_p->sstacksize = sstack;
-					tcb_p->ustacksize = ustack;
-					tcb_p->flags = flags;
+{
+#if defined(__GNUC__)
+	return ((UINT)(31 - __builtin_clz (word)));
+#else
+	unsigned long bit;
 
-					tcb_p->state = TS_CREATED;
+	_BitScanReverse (&bit, word);
 
-					/*
-					 * return the runtime task id
-					 */
-					
-					*tid = inx;
+	return ((UINT)bit);
+#endif
+}
 
-					++TotalTaskCount;
+/******************************************************************************
+*						  
+* Name:				edf_before
+*
+* Type:				Function
+*
+* Description:		TRUE if task a's deadline is earlier than task b's
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
 
-					rtn = 0;
-					break;
-				}
-			}
-		}
-	}
-	else
-	{
-		rtn = ERR_NOTCB;
-	}
+static UINT edf_before(UINT a, UINT b)
 
-	return (rtn);
+{
+	return ((LONG)(TaskList[a].deadline - TaskList[b].deadline) < 0);
 }
 
 /******************************************************************************
 *						  
-* Name:				t_delete
+* Name:				edf_sift
 *
 * Type:				Function
 *
-* Description:		
+* Description:		move a deadline heap entry up or down into place
 * 
 * Formal Inputs:	
 *
@@ -256,53 +442,49 @@ ULONG t_create(char name[4], ULONG prio, ULONG sstack, ULONG ustack, ULONG flags
 *
 ******************************************************************************/
 
-ULONG t_delete(ULONG tid)
+static void edf_sift(GXKCORE *core_p, UINT pos)
 
 {
-	ULONG rtn;
+	UINT tid;
+	UINT up;
+	UINT down;
 
-	rtn = 0;
+	tid = core_p->edf[pos];
 
-	if (tid < MAX_TASK)
+	while ((pos > 0) && edf_before (tid, core_p->edf[(pos - 1) / 2]))
 	{
-		if (TaskList[tid].state == TS_DEAD)
+		up = (pos - 1) / 2;
+
+		core_p->edf[pos] = core_p->edf[up];
+		TaskList[core_p->edf[pos]].hpos = pos;
+		pos = up;
+	}
+
+	while ((down = 2 * pos + 1) < core_p->nedf)
+	{
+		if ((down + 1 < core_p->nedf) && edf_before (core_p->edf[down + 1], core_p->edf[down]))
 		{
-			rtn = ERR_OBJDEL;
+			++down;
 		}
-		else
-		{
-			/*
-			 * kill it
-			 */
-
-			if (CloseHandle(TaskList[tid].w32id) == 0)
 
-			{
-				rtn = ERR_OBJDEL;
-			}
+		if (edf_before (core_p->edf[down], tid) == FALSE) break;
 
-			/*
-			 * clear local data for task and reset state
-			 */
-			
-			clear_gxktcb (tid);
-		}
-	}
-	else
-	{
-		rtn = ERR_OBJID;
+		core_p->edf[pos] = core_p->edf[down];
+		TaskList[core_p->edf[pos]].hpos = pos;
+		pos = down;
 	}
 
-	return (rtn);
+	core_p->edf[pos] = tid;
+	TaskList[tid].hpos = pos;
 }
 
 /******************************************************************************
 *						  
-* Name:				t_getreg
+* Name:				edf_push
 *
 * Type:				Function
 *
-* Description:		
+* Description:		put a task on its core's deadline heap
 * 
 * Formal Inputs:	
 *
@@ -318,65 +500,21 @@ ULONG t_delete(ULONG tid)
 *
 ******************************************************************************/
 
-ULONG t_getreg(ULONG tid, ULONG regnum, ULONG *reg_value)
+static void edf_push(GXKCORE *core_p, UINT tid)
 
 {
-	ULONG rtn;
-	GXKTCB *pTcb;
-	unsigned threadid;
-	ULONG Index;
-
-	rtn = 0;
-
-	if (tid < MAX_TASK)
-	{
-		if (tid == 0)
-		{
-			/*
-			 * determine who the calling task is
-			 */
-			
-			threadid = GetCurrentThreadId ();
+	core_p->edf[core_p->nedf] = tid;
 
-			for (Index = 0, pTcb = TaskList; Index < MAX_TASK; Index++, pTcb++)
-			{
-				if (pTcb->threadid == threadid) break;
-			}
-		}
-		else
-		{
-			pTcb = &TaskList[tid];
-		}
-
-		if ((pTcb->state == TS_DEAD) || (Index == MAX_TASK))
-		{
-			rtn = ERR_OBJDEL;
-		}
-		else if (regnum > REG_CNT)
-		{
-			rtn = ERR_REGNUM;
-		}
-		else
-		{
-			*reg_value = pTcb->reg[regnum];
-			rtn = 0;
-		}
-	}
-	else
-	{
-		rtn = ERR_OBJID;
-	}
-
-	return (rtn);
+	edf_sift (core_p, core_p->nedf++);
 }
 
 /******************************************************************************
 *						  
-* Name:				t_ident
+* Name:				edf_pull
 *
 * Type:				Function
 *
-* Description:		
+* Description:		take a task off its core's deadline heap
 * 
 * Formal Inputs:	
 *
@@ -392,66 +530,29 @@ ULONG t_getreg(ULONG tid, ULONG regnum, ULONG *reg_value)
 *
 ******************************************************************************/
 
-ULONG t_ident(char name[4], ULONG node, ULONG *tid)
+static void edf_pull(GXKCORE *core_p, UINT tid)
 
 {
-	ULONG rtn;
-	UINT inx;
-	GXKTCB *tcb_p;
-	unsigned threadid;
-
-	rtn = ERR_OBJNF;
+	UINT pos;
 
-	/*
-	 * if name parameter is NULL, get ID of current thread
-	 */
-	
-	if (name == 0)
-	{
-		threadid = GetCurrentThreadId ();
+	pos = TaskList[tid].hpos;
+	TaskList[tid].hpos = NO_HEAP;
 
-		for (inx = 0, tcb_p = TaskList; inx < MAX_TASK; inx++, tcb_p++)
-		{
-			if (tcb_p->threadid == threadid)
-			{
-				rtn = 0;
-				*tid = inx;
-				break;
-			}
-		}
-	}
-	else
+	if (pos < --core_p->nedf)
 	{
-		/*
-		 * otherwise, get ID of specified thread
-		 */
-		
-		for (inx = 0; inx < MAX_TASK; inx++)
-		{
-			tcb_p = &TaskList[inx];
+		core_p->edf[pos] = core_p->edf[core_p->nedf];
 
-			if ((tcb_p->name[0] == name[0]) &&
-				 (tcb_p->name[1] == name[1]) &&
-					(tcb_p->name[2] == name[2]) &&
-						 (tcb_p->name[3] == name[3]))
-			{
-				rtn = 0;
-				*tid = inx;
-				break;
-			}
-		}
+		edf_sift (core_p, pos);
 	}
-	
-	return (rtn);
 }
 
 /******************************************************************************
 *						  
-* Name:				t_mode
+* Name:				ready_insert
 *
 * Type:				Function
 *
-* Description:		
+* Description:		link a task into its core's run queue at its priority
 * 
 * Formal Inputs:	
 *
@@ -467,38 +568,52 @@ ULONG t_ident(char name[4], ULONG node, ULONG *tid)
 *
 ******************************************************************************/
 
-ULONG t_mode(ULONG mask, ULONG new_mode, ULONG *old_mode)
+static void ready_insert(UINT tid, UINT head)
 
 {
-	*old_mode = TaskList[CurrentTask].mode;
+	GXKTCB *tcb_p;
+	GXKCORE *core_p;
+	UINT lvl;
+
+	tcb_p = &TaskList[tid];
+	core_p = &Cores[tcb_p->core];
+	lvl = (UINT)tcb_p->prio - 1;
 
-	if (mask & T_NOPREEMPT)
+	tcb_p->next = tcb_p->prev = MAX_TASK;
+
+	if ((tcb_p->edf) && (lvl == EDF_LVL))
 	{
-		TaskList[CurrentTask].mode |= (new_mode & T_NOPREEMPT);
+		/* an inherited priority puts it back on the lists */
+		edf_push (core_p, tid);
 	}
-	if (mask & T_TSLICE)
+	else if (core_p->head[lvl] == MAX_TASK)
 	{
-		TaskList[CurrentTask].mode |= (new_mode & T_TSLICE);
+		core_p->head[lvl] = core_p->tail[lvl] = tid;
 	}
-	if (mask & T_NOASR)
+	else if (head)
 	{
-		TaskList[CurrentTask].mode |= (new_mode & T_NOASR);
+		tcb_p->next = core_p->head[lvl];
+		TaskList[core_p->head[lvl]].prev = tid;
+		core_p->head[lvl] = tid;
 	}
-	if (mask & T_NOISR)
+	else
 	{
-		TaskList[CurrentTask].mode |= (new_mode & T_NOISR);
+		tcb_p->prev = core_p->tail[lvl];
+		TaskList[core_p->tail[lvl]].next = tid;
+		core_p->tail[lvl] = tid;
 	}
 
-	return (0);  /* always returns 0 */
+	core_p->map[lvl >> 5] |= (1U << (lvl & 31));
+	core_p->group |= (1U << (lvl >> 5));
 }
 
 /******************************************************************************
 *						  
-* Name:				t_restart
+* Name:				ready_remove
 *
 * Type:				Function
 *
-* Description:		
+* Description:		unlink a task from the ready queue
 * 
 * Formal Inputs:	
 *
@@ -514,63 +629,66 @@ ULONG t_mode(ULONG mask, ULONG new_mode, ULONG *old_mode)
 *
 ******************************************************************************/
 
-ULONG t_restart(ULONG tid, ULONG targs[])
+static void ready_remove(UINT tid)
 
 {
-	ULONG rtn;
-	ULONG mode;
-	void *start_addr;
+	GXKTCB *tcb_p;
+	GXKCORE *core_p;
+	UINT lvl;
 
-	rtn = 0;
+	tcb_p = &TaskList[tid];
+	core_p = &Cores[tcb_p->core];
+	lvl = (UINT)tcb_p->prio - 1;
 
-	if (tid < MAX_TASK)
+	/*
+	 * a heap task is on no list, so only the heap is fixed up
+	 */
+
+	if (tcb_p->hpos != NO_HEAP)
 	{
-		if (TaskList[tid].state == TS_DEAD)
+		edf_pull (core_p, tid);
+	}
+	else
+	{
+		if (tcb_p->prev == MAX_TASK)
 		{
-			rtn = ERR_OBJDEL;
+			core_p->head[lvl] = tcb_p->next;
 		}
-		else if (TaskList[tid].state == TS_CREATED)
+		else
 		{
-			rtn = ERR_NACTIVE;
+			TaskList[tcb_p->prev].next = tcb_p->next;
+		}
+
+		if (tcb_p->next == MAX_TASK)
+		{
+			core_p->tail[lvl] = tcb_p->prev;
 		}
 		else
 		{
-			/*
-			 * save parameters to be reused, then init tcb
-			 */
-
-			mode = TaskList[tid].mode;
-			start_addr = TaskList[tid].start_addr;
-			clear_gxktcb (tid);
+			TaskList[tcb_p->next].prev = tcb_p->prev;
+		}
+	}
 
-			/*
-			 * kill task
-			 */
+	tcb_p->next = tcb_p->prev = MAX_TASK;
 
-			t_delete(tid);
+	if ((core_p->head[lvl] == MAX_TASK) && ((lvl != EDF_LVL) || (core_p->nedf == 0)))
+	{
+		core_p->map[lvl >> 5] &= ~(1U << (lvl & 31));
 
-			/*
-			 * start task
-			 */
-			
-			rtn = t_start(tid, mode, start_addr, targs);
+		if (core_p->map[lvl >> 5] == 0)
+		{
+			core_p->group &= ~(1U << (lvl >> 5));
 		}
 	}
-	else
-	{
-		rtn = ERR_OBJID;
-	}
-
-	return (rtn);
 }
 
 /******************************************************************************
 *						  
-* Name:				t_resume
+* Name:				ready_highest
 *
 * Type:				Function
 *
-* Description:		
+* Description:		head of the highest priority non-empty ready list
 * 
 * Formal Inputs:	
 *
@@ -586,50 +704,38 @@ ULONG t_restart(ULONG tid, ULONG targs[])
 *
 ******************************************************************************/
 
-ULONG t_resume(ULONG tid)
+static UINT ready_highest(UINT core)
 
 {
-	ULONG rtn;
+	GXKCORE *core_p;
+	UINT grp;
+	UINT lvl;
 
-	rtn = 0;
+	core_p = &Cores[core];
 
-	if (tid < MAX_TASK)
+	if (core_p->group == 0)
 	{
-		if (TaskList[tid].state == TS_DEAD)
-		{
-			rtn = ERR_OBJDEL;
-		}
-		else if (TaskList[tid].state != TS_SUSPEND)
-		{
-			rtn = ERR_NOTSUSP;
-		}
-		else
-		{
-			/*
-			 * resume thread and update state
-			 */
+		return (MAX_TASK);
+	}
 
-			ResumeThread (TaskList[tid].w32id); 
-			TaskList[tid].state = TS_RUNNING;
+	grp = msb32 (core_p->group);
+	lvl = (grp << 5) + msb32 (core_p->map[grp]);
 
-			rtn = 0;
-		}
-	}
-	else
+	if ((lvl == EDF_LVL) && (core_p->nedf != 0))
 	{
-		rtn = ERR_OBJID;
+		return (core_p->edf[0]);
 	}
 
-	return (rtn);
+	return (core_p->head[lvl]);
 }
 
 /******************************************************************************
 *						  
-* Name:				t_setpri
+* Name:				core_running
 *
 * Type:				Function
 *
-* Description:		
+* Description:		core a task is running on, NUM_CORES if none
 * 
 * Formal Inputs:	
 *
@@ -645,55 +751,68 @@ ULONG t_resume(ULONG tid)
 *
 ******************************************************************************/
 
-ULONG t_setpri(ULONG tid, ULONG newprio, ULONG *oldprio)
+static UINT core_running(UINT tid)
 
 {
-	ULONG rtn;
+	UINT core;
 
-	rtn = 0;
+	for (core = 0; core < NUM_CORES; core++)
+	{
+		if (Cores[core].current == tid) break;
+	}
 
-	/*
-	 * return current priority
-	 */
+	return (core);
+}
+
+/******************************************************************************
+*						  
+* Name:				core_place
+*
+* Type:				Function
+*
+* Description:		choose the core a task is queued on within its affinity
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
 
-	*oldprio = TaskList[tid].prio;
+static UINT core_place(UINT mask, UINT from)
 
-	if (tid < MAX_TASK)
-	{
-		if (TaskList[tid].state == TS_DEAD)
-		{
-			rtn = ERR_OBJDEL;
-		}
-		else if ((newprio < MIN_PRIO) || (newprio > MAX_PRIO))
-		{
-			rtn = ERR_SETPRI;
-		}
-		else
-		{
-			/*
-			 * priority is meaningless in win32 environment
-			 */
+{
+	UINT core;
+	UINT inx;
 
-			TaskList[tid].prio = newprio;
+	/*
+	 * the first core of the mask at or after from, round robin
+	 */
 
-			rtn = 0;
-		}
-	}
-	else
+	for (inx = 0; inx < NUM_CORES; inx++)
 	{
-		rtn = ERR_OBJID;
+		core = (from + inx) % NUM_CORES;
+
+		if (mask & (1U << core)) break;
 	}
 
-	return (rtn);
+	return (core);
 }
 
 /******************************************************************************
 *						  
-* Name:				t_setreg
+* Name:				core_movable
 *
 * Type:				Function
 *
-* Description:		
+* Description:		strongest waiting task on one core that may move to another
 * 
 * Formal Inputs:	
 *
@@ -709,63 +828,77 @@ ULONG t_setpri(ULONG tid, ULONG newprio, ULONG *oldprio)
 *
 ******************************************************************************/
 
-ULONG t_setreg(ULONG tid, ULONG regnum, ULONG reg_value)
+static UINT core_movable(UINT from, UINT to, ULONG floor)
 
 {
-	ULONG rtn;
-	GXKTCB *pTcb;
+	GXKCORE *core_p;
+	UINT grp;
+	UINT bits;
+	UINT lvl;
+	UINT tid;
+	UINT pos;
+	UINT best;
 
-	rtn = 0;
-
-	if (tid < MAX_TASK)
-	{
-		if (tid == 0)
-		{
-			/*
-			 * only used to associate w32 tid with our tid
-			 * determine who the calling task is;
-			 * reg_value was our TCB index when thread was created
-			 */
+	/*
+	 * ready tasks above priority floor, not running and allowed on
+	 * core to, strongest first
+	 */
 
-			pTcb = &TaskList[reg_value];
+	core_p = &Cores[from];
 
-			pTcb->threadid = GetCurrentThreadId ();
-			rtn = 0;
-		}
-		else
+	for (grp = PRIO_WORDS; grp-- > 0; )
+	{
+		for (bits = core_p->map[grp]; bits != 0; bits &= ~(1U << lvl))
 		{
-			pTcb = &TaskList[tid];
+			lvl = msb32 (bits);
 
-			if (pTcb->state == TS_DEAD)
+			if ((grp << 5) + lvl + 1 <= floor)
 			{
-				rtn = ERR_OBJDEL;
+				return (MAX_TASK);
 			}
-			else if (regnum > REG_CNT)
+
+			if ((grp << 5) + lvl == EDF_LVL)
 			{
-				rtn = ERR_REGNUM;
+				/* the earliest deadline that may move */
+				best = MAX_TASK;
+
+				for (pos = 0; pos < core_p->nedf; pos++)
+				{
+					tid = core_p->edf[pos];
+
+					if ((tid != core_p->current) && (TaskList[tid].affinity & (1U << to)) &&
+						((best == MAX_TASK) || edf_before (tid, best)))
+					{
+						best = tid;
+					}
+				}
+
+				if (best < MAX_TASK)
+				{
+					return (best);
+				}
 			}
-			else
+
+			for (tid = core_p->head[(grp << 5) + lvl]; tid != MAX_TASK; tid = TaskList[tid].next)
 			{
-				pTcb->reg[regnum] = reg_value;
-				rtn = 0;
+				if ((tid != core_p->current) && (TaskList[tid].affinity & (1U << to)))
+				{
+					return (tid);
+				}
 			}
 		}
 	}
-	else
-	{
-		rtn = ERR_OBJID;
-	}
 
-	return (rtn);
+	return (MAX_TASK);
 }
 
 /******************************************************************************
 *						  
-* Name:				t_start
+* Name:				core_steal
 *
 * Type:				Function
 *
-* Description:		
+* Description:		take over a stronger ready task waiting on another core
 * 
 * Formal Inputs:	
 *
@@ -781,71 +914,46 @@ ULONG t_setreg(ULONG tid, ULONG regnum, ULONG reg_value)
 *
 ******************************************************************************/
 
-ULONG t_start(ULONG tid, ULONG mode, void (*start_addr)(), ULONG targs[])
+static UINT core_steal(UINT core, ULONG floor)
 
 {
-	ULONG rtn;
-	GXKTCB *tcb_p;
+	UINT best;
+	UINT from;
+	UINT tid;
 
-	rtn = 0;
+	best = MAX_TASK;
 
-	if (tid < MAX_TASK)
+	for (from = 0; from < NUM_CORES; from++)
 	{
-		tcb_p = &TaskList[tid];
-
-		if (tcb_p->state == TS_DEAD)
-		{
-			rtn = ERR_OBJDEL;
-		}
-		else if (tcb_p->state != TS_CREATED)
-		{
-			rtn = ERR_ACTIVE;
-		}
-		else
+		if (from != core)
 		{
-			/*
-			 * init startup data
-			 */
+			tid = core_movable (from, core, floor);
 
-			tcb_p->mode = mode;
-			tcb_p->start_addr = start_addr;
-
-			tcb_p->state = TS_RUNNING;
-			
-			/*
-			 * start the task
-			 */
-			
-			if ((tcb_p->w32id = _beginthreadex(NULL,
-				                              tcb_p->sstacksize,
-									          (unsigned (__stdcall *)(void *))start_addr,
-									          targs,
-									          0,
-									          &tcb_p->threadid)) == 0)
+			if (tid < MAX_TASK)
 			{
-				rtn = ERR_OBJDEL;
-			}
-			else
-			{
-				rtn = 0;
+				best = tid;
+				floor = TaskList[tid].prio;
 			}
 		}
 	}
-	else
+
+	if (best < MAX_TASK)
 	{
-		rtn = ERR_OBJID;
+		ready_remove (best);
+		TaskList[best].core = core;
+		ready_insert (best, FALSE);
 	}
 
-	return (rtn);
+	return (best);
 }
 
 /******************************************************************************
 *						  
-* Name:				t_suspend
+* Name:				sched_admit
 *
 * Type:				Function
 *
-* Description:		
+* Description:		TRUE if the periodic tasks pass the policy's utilization test
 * 
 * Formal Inputs:	
 *
@@ -861,51 +969,58 @@ ULONG t_start(ULONG tid, ULONG mode, void (*start_addr)(), ULONG targs[])
 *
 ******************************************************************************/
 
-ULONG t_suspend(ULONG tid)
+static UINT sched_admit(UINT tid, ULONG deadline, ULONG cost)
 
 {
-	ULONG rtn;
+	static const UINT rm_bound[11] = {1000, 1000, 828, 779, 756, 743, 734, 728, 724, 720, 717};
+	UINT inx;
+	UINT n;
+	ULONG load;
+	ULONG bound;
 
-	rtn = 0;
+	/*
+	 * load is the sum of cost / deadline in parts per thousand,
+	 * rounded up, with tid's new figures in place of its old ones.
+	 * rate monotonic takes the Liu and Layland bound n(2^(1/n) - 1),
+	 * which falls to ln 2 for large n; earliest deadline first takes
+	 * the whole core
+	 */
 
-	if (tid < MAX_TASK)
+	n = 1;
+	load = (cost * 1000 + deadline - 1) / deadline;
+
+	for (inx = 0; inx < MAX_TASK; inx++)
 	{
-		if (TaskList[tid].state == TS_DEAD)
-		{
-			rtn = ERR_OBJDEL;
-		}
-		else if (TaskList[tid].state == TS_SUSPEND)
+		if ((inx != tid) && (TaskMeta[inx].period != 0) && (TaskList[inx].state != TS_DEAD))
 		{
-			rtn = ERR_SUSP;
+			++n;
+			load += (TaskMeta[inx].cost * 1000 + TaskMeta[inx].drel - 1) / TaskMeta[inx].drel;
 		}
-		else
-		{
-			/*
-			 * suspend thread and update state
-			 */
-
-			SuspendThread (TaskList[tid].w32id); 
-			TaskList[tid].state = TS_SUSPEND;
+	}
 
-			rtn = 0;
-		}
+	if (SCHED_POLICY == SCHED_RM)
+	{
+		bound = (n <= 10) ? rm_bound[n] : 693;
+	}
+	else if (SCHED_POLICY == SCHED_EDF)
+	{
+		bound = 1000;
 	}
 	else
 	{
-		rtn = ERR_OBJID;
+		bound = ~0UL;
 	}
 
-	return (rtn);
+	return (load <= bound);
 }
 
-
 /******************************************************************************
 *						  
-* Name:				gxk_t_getTid
+* Name:				sched_charge
 *
 * Type:				Function
 *
-* Description:		
+* Description:		account a core switching from one task to another
 * 
 * Formal Inputs:	
 *
@@ -921,34 +1036,37 @@ ULONG t_suspend(ULONG tid)
 *
 ******************************************************************************/
 
-ULONG gxk_t_getTid(unsigned threadid, ULONG *tid)
+static void sched_charge(UINT out, UINT in)
 
 {
-	ULONG rtn;
-	UINT inx;
+	LONGLONG cnt;
 
-	rtn = 1;
+	/*
+	 * run time is kept in host clock counts and turned into
+	 * milliseconds by t_info; either task may be MAX_TASK
+	 */
 
-	for (inx = 0; inx < MAX_TASK; inx++)
+	cnt = gxk_h_clock ();
+
+	if (out < MAX_TASK)
 	{
-		if (TaskList[inx].threadid == threadid)
-		{
-			*tid = inx;
-			rtn = 0;
-			break;
-		}
+		TaskList[out].run += cnt - TaskList[out].since;
 	}
 
-	return (rtn);
+	if (in < MAX_TASK)
+	{
+		TaskList[in].since = cnt;
+		TaskList[in].switches++;
+	}
 }
 
 /******************************************************************************
 *						  
-* Name:				gxk_t_init
+* Name:				sched_rm
 *
 * Type:				Function
 *
-* Description:		
+* Description:		give periodic tasks rate monotonic priorities
 * 
 * Formal Inputs:	
 *
@@ -964,19 +1082,2894 @@ ULONG gxk_t_getTid(unsigned threadid, ULONG *tid)
 *
 ******************************************************************************/
 
-ULONG gxk_t_init()
+static void sched_rm(void)
 
 {
+	ULONG period[MAX_TASK];
+	UINT n;
 	UINT inx;
+	UINT pos;
+	UINT mov;
+	ULONG prio;
+	ULONG inherit;
 
-	TotalTaskCount = 0;
-	TotalStackUsed = 0;
+	/*
+	 * sort the distinct periods, shortest first; a task's priority is
+	 * PERIOD_PRIO less the place of its period, so equal periods
+	 * share a priority
+	 */
 
-	CurrentTask = MAX_TASK;
+	n = 0;
 
 	for (inx = 0; inx < MAX_TASK; inx++)
 	{
-		clear_gxktcb (inx);
+		if ((TaskMeta[inx].period != 0) && (TaskList[inx].state != TS_DEAD))
+		{
+			for (pos = 0; (pos < n) && (period[pos] < TaskMeta[inx].period); pos++)
+			{
+			}
+
+			if ((pos == n) || (period[pos] != TaskMeta[inx].period))
+			{
+				for (mov = n++; mov > pos; mov--)
+				{
+					period[mov] = period[mov - 1];
+				}
+
+				period[pos] = TaskMeta[inx].period;
+			}
+		}
+	}
+
+	for (inx = 0; inx < MAX_TASK; inx++)
+	{
+		if ((TaskMeta[inx].period != 0) && (TaskList[inx].state != TS_DEAD))
+		{
+			for (pos = 0; period[pos] != TaskMeta[inx].period; pos++)
+			{
+			}
+
+			prio = (pos < PERIOD_PRIO) ? PERIOD_PRIO - pos : MIN_PRIO;
+
+			TaskMeta[inx].bprio = prio;
+
+			inherit = gxk_mu_ceiling (inx);
+
+			gxk_t_setprio (inx, (inherit > prio) ? inherit : prio);
+		}
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				waitq_insert
+*
+* Type:				Function
+*
+* Description:		append a task to a kernel object wait queue
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void waitq_insert(GXKWAITQ *wq, UINT tid)
+
+{
+	GXKTCB *tcb_p;
+	UINT next;
+
+	tcb_p = &TaskList[tid];
+
+	/*
+	 * FIFO queues append; priority queues go in front of the first
+	 * lower priority waiter, so equal priorities stay FIFO
+	 */
+
+	next = MAX_TASK;
+
+	if (wq->prior)
+	{
+		for (next = wq->head; next != MAX_TASK; next = TaskList[next].wnext)
+		{
+			if (TaskList[next].prio < tcb_p->prio) break;
+		}
+	}
+
+	tcb_p->waitq = wq;
+	tcb_p->wnext = next;
+	tcb_p->wprev = (next == MAX_TASK) ? wq->tail : TaskList[next].wprev;
+
+	if (tcb_p->wprev == MAX_TASK)
+	{
+		wq->head = tid;
+	}
+	else
+	{
+		TaskList[tcb_p->wprev].wnext = tid;
+	}
+
+	if (next == MAX_TASK)
+	{
+		wq->tail = tid;
+	}
+	else
+	{
+		TaskList[next].wprev = tid;
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				waitq_remove
+*
+* Type:				Function
+*
+* Description:		unlink a task from the wait queue it is blocked on
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void waitq_remove(UINT tid)
+
+{
+	GXKTCB *tcb_p;
+	GXKWAITQ *wq;
+
+	tcb_p = &TaskList[tid];
+	wq = tcb_p->waitq;
+
+	if (tcb_p->wprev == MAX_TASK)
+	{
+		wq->head = tcb_p->wnext;
+	}
+	else
+	{
+		TaskList[tcb_p->wprev].wnext = tcb_p->wnext;
+	}
+
+	if (tcb_p->wnext == MAX_TASK)
+	{
+		wq->tail = tcb_p->wprev;
+	}
+	else
+	{
+		TaskList[tcb_p->wnext].wprev = tcb_p->wprev;
+	}
+
+	tcb_p->wnext = tcb_p->wprev = MAX_TASK;
+	tcb_p->waitq = NULL;
+}
+
+/******************************************************************************
+*						  
+* Name:				stop_thread
+*
+* Type:				Function
+*
+* Description:		take the CPU from a task that is running its body
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void stop_thread(UINT tid)
+
+{
+	/*
+	 * the thread is not stopped where it is, as it may hold host
+	 * locks there; it parks on its next way out of the kernel.  until
+	 * then HOST_FIFO has the host run the task dispatched in its
+	 * place ahead of it.  one not yet out of gxk_t_park stays there
+	 */
+
+	if (TaskList[tid].body)
+	{
+		TaskList[tid].preempted = TRUE;
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				start_thread
+*
+* Type:				Function
+*
+* Description:		let the thread of a dispatched task run
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void start_thread(UINT tid)
+
+{
+	GXKTCB *tcb_p;
+	GXKWORKER *wk;
+
+	tcb_p = &TaskList[tid];
+
+	/*
+	 * pooled threads follow the core they are dispatched on, also on
+	 * one core when the host orders them by priority
+	 */
+
+	if (((NUM_CORES > 1) || (HOST_POSIX && HOST_FIFO)) && (tcb_p->worker < MAX_WORKER))
+	{
+		wk = &Workers[tcb_p->worker];
+
+		if (wk->core != tcb_p->core)
+		{
+			gxk_h_affinity (wk->thread, tcb_p->core);
+			wk->core = tcb_p->core;
+		}
+	}
+
+	/*
+	 * dispatched again before it parked, it simply carries on
+	 */
+
+	if (tcb_p->preempted)
+	{
+		tcb_p->preempted = FALSE;
+	}
+	else if (tcb_p->worker < MAX_WORKER)
+	{
+		gxk_h_evset (Workers[tcb_p->worker].gate);
+	}
+	else
+	{
+		gxk_h_evset (TaskMeta[tid].gate);
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				worker_spawn
+*
+* Type:				Function
+*
+* Description:		start the thread of an empty worker slot
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static ULONG worker_spawn(UINT w, ULONG stack)
+
+{
+	ULONG rtn;
+	GXKWORKER *wk;
+
+	rtn = 0;
+	wk = &Workers[w];
+
+	if ((wk->thread = gxk_h_thread (worker_main, wk, stack, &wk->threadid)) == NULL)
+	{
+		rtn = ERR_OBJDEL;
+	}
+	else
+	{
+		wk->stack = stack;
+		wk->core = NUM_CORES;
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				worker_put
+*
+* Type:				Function
+*
+* Description:		return a worker to the pool
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void worker_put(GXKWORKER *wk)
+
+{
+	UINT w;
+
+	w = (UINT)(wk - Workers);
+
+	wk->tid = MAX_TASK;
+	wk->recall = FALSE;
+	wk->next = WorkerFree;
+
+	WorkerFree = w;
+}
+
+/******************************************************************************
+*						  
+* Name:				worker_get
+*
+* Type:				Function
+*
+* Description:		take a pooled worker with at least the stack asked for
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static UINT worker_get(ULONG stack)
+
+{
+	UINT w;
+	UINT prev;
+	UINT empty;
+	UINT eprev;
+
+	/*
+	 * the first parked thread that fits, else an empty slot that a
+	 * thread is started in
+	 */
+
+	empty = eprev = MAX_WORKER;
+
+	for (prev = MAX_WORKER, w = WorkerFree; w != MAX_WORKER; prev = w, w = Workers[w].next)
+	{
+		if (Workers[w].thread == NULL)
+		{
+			if (empty == MAX_WORKER)
+			{
+				empty = w;
+				eprev = prev;
+			}
+		}
+		else if (Workers[w].stack >= stack)
+		{
+			break;
+		}
+	}
+
+	if (w == MAX_WORKER)
+	{
+		if ((empty == MAX_WORKER) || (worker_spawn (empty, (stack > MAX_TSTACK) ? stack : MAX_TSTACK) != 0))
+		{
+			return (MAX_WORKER);
+		}
+
+		w = empty;
+		prev = eprev;
+	}
+
+	if (prev == MAX_WORKER)
+	{
+		WorkerFree = Workers[w].next;
+	}
+	else
+	{
+		Workers[prev].next = Workers[w].next;
+	}
+
+	Workers[w].next = MAX_WORKER;
+
+	return (w);
+}
+
+/******************************************************************************
+*						  
+* Name:				worker_lose
+*
+* Type:				Function
+*
+* Description:		empty the slot of a worker left stopped for good
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void worker_lose(UINT w)
+
+{
+	gxk_h_close (Workers[w].thread);
+
+	Workers[w].thread = NULL;
+	Workers[w].threadid = 0;
+
+	worker_put (&Workers[w]);
+}
+
+/******************************************************************************
+*						  
+* Name:				worker_main
+*
+* Type:				Function
+*
+* Description:		thread entry of every pool worker
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static unsigned HOST_CALL worker_main(void *arg)
+
+{
+	GXKWORKER *wk;
+	GXKTMETA *meta_p;
+
+	wk = (GXKWORKER *)arg;
+
+	SelfWorker = wk;
+
+	for (;;)
+	{
+		gxk_h_evwait (wk->wake, INFINITE);
+
+		/*
+		 * a task that is deleted or restarted, by itself or while
+		 * parked, comes back here by longjmp from t_delete,
+		 * t_restart or gxk_t_park
+		 */
+
+		if (setjmp (wk->home) == 0)
+		{
+			SelfTask = wk->tid;
+
+			/*
+			 * hold off until dispatched, then run the task body
+			 */
+
+			gxk_t_park (INFINITE);
+
+			meta_p = &TaskMeta[SelfTask];
+
+			((void (*)(ULONG *))meta_p->start_addr) (meta_p->targs);
+
+			/*
+			 * task returned from its entry point; it cannot run again
+			 */
+
+			t_delete ((ULONG)SelfTask);
+		}
+
+		SelfTask = MAX_TASK;
+
+		gxk_k_lock ();
+		worker_put (wk);
+		gxk_k_leave ();
+	}
+
+	return (0);
+}
+
+
+/******************************************************************************
+*						  
+* Name:				start_task
+*
+* Type:				Function
+*
+* Description:		hand a task to a pool worker and make it ready
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static ULONG start_task(UINT tid)
+
+{
+	ULONG rtn;
+	UINT w;
+	GXKTCB *tcb_p;
+
+	tcb_p = &TaskList[tid];
+
+	/*
+	 * the worker is told its task before it is woken; it then waits
+	 * in gxk_t_park to be dispatched
+	 */
+
+	if ((w = worker_get (TaskMeta[tid].sstacksize + TaskMeta[tid].ustacksize)) == MAX_WORKER)
+	{
+		rtn = ERR_OBJDEL;
+	}
+	else
+	{
+		tcb_p->worker = w;
+		TaskMeta[tid].thread = Workers[w].thread;
+		TaskThread[tid] = Workers[w].threadid;
+		gxk_h_setprio (Workers[w].thread, tcb_p->prio);
+
+		Workers[w].tid = tid;
+
+		tcb_p->state = TS_RUNNING;
+		ready_insert (tid, FALSE);
+
+		gxk_h_evset (Workers[w].wake);
+
+		rtn = 0;
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				stop_task
+*
+* Type:				Function
+*
+* Description:		take a task out of scheduling and release its worker
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static ULONG stop_task(UINT tid, UINT self)
+
+{
+	ULONG rtn;
+	UINT core;
+	UINT running;
+	UINT body;
+	GXKTCB *tcb_p;
+
+	rtn = 0;
+	tcb_p = &TaskList[tid];
+
+	if (tcb_p->state == TS_RUNNING)
+	{
+		ready_remove (tid);
+	}
+
+	if (tcb_p->waitq != NULL)
+	{
+		waitq_remove (tid);
+	}
+
+	/* timers armed by the task die with it */
+	gxk_tm_purge (tid);
+
+	/* and buffers it cached go back to their partitions */
+	gxk_pt_purge (tid);
+
+	/* waiters its rn_getseg held back are served */
+	gxk_rn_purge (tid);
+
+	/* mutexes it holds pass to their next waiter */
+	gxk_mu_purge (tid);
+
+	/* and an sl_wait it is blocked in is withdrawn */
+	gxk_sl_purge (tid);
+
+	/* its ASR and the signals still pending go */
+	gxk_as_purge (tid);
+
+	core = core_running (tid);
+	running = (core < NUM_CORES);
+	body = tcb_p->body;
+
+	tcb_p->pend = FALSE;
+	tcb_p->body = FALSE;
+	tcb_p->preempted = FALSE;
+
+	if (running)
+	{
+		Cores[core].current = MAX_TASK;
+	}
+
+	if ((tcb_p->worker < MAX_WORKER) && (tid != self))
+	{
+		if (body)
+		{
+			/*
+			 * somewhere in the task body, preempted on its way to
+			 * park or running on another core or when deleted from
+			 * outside any task; it cannot be sent home from there and
+			 * must not run on, so the thread is stopped for good and
+			 * its slot takes a new one later
+			 */
+
+			gxk_h_stop (TaskMeta[tid].thread);
+
+			worker_lose (tcb_p->worker);
+		}
+		else
+		{
+			/*
+			 * parked in gxk_t_park, holding no kernel state; it
+			 * returns to the pool when it sees the recall
+			 */
+
+			Workers[tcb_p->worker].recall = TRUE;
+			gxk_h_evset (Workers[tcb_p->worker].gate);
+		}
+	}
+
+	/*
+	 * the caller's own worker goes home once the kernel is left
+	 */
+
+	tcb_p->worker = MAX_WORKER;
+	TaskMeta[tid].thread = NULL;
+	TaskThread[tid] = 0;
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				t_create
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+		  
+ULONG t_create(char name[4], ULONG prio, ULONG sstack, ULONG ustack, ULONG flags, ULONG *tid)
+
+{
+	ULONG rtn;
+	UINT inx;
+	GXKTCB *tcb_p;
+	GXKTMETA *meta_p;
+
+	gxk_k_lock ();
+	
+	if (TotalTaskCount < MAX_TASK)
+	{
+		if ((sstack < MIN_TSTACK) && (ustack < MIN_TSTACK))
+		{
+			rtn = ERR_TINYSTK;
+		}
+		else if ((sstack + ustack + TotalStackUsed) > MAX_SSTACK)
+		{
+			rtn = ERR_NOSTK;
+		}
+		else if ((prio < MIN_PRIO) || (prio > MAX_PRIO))
+		{
+			rtn = ERR_PRIOR;
+		}
+		else if ((T_CORESOF (flags) != 0) && ((T_CORESOF (flags) & CORE_ALL) == 0))
+		{
+			rtn = ERR_NOCORE;
+		}
+		else
+		{
+			/*
+			 * all parameters check OK - setup global data
+			 */
+
+			TotalStackUsed += sstack + ustack;
+
+			rtn = ERR_NOTCB;
+
+			for (inx = 0; inx < MAX_TASK; inx++)
+			{
+				tcb_p = &TaskList[inx];
+
+				if (tcb_p->state == TS_DEAD)
+				{
+					/*
+					 * initialize the task control block
+					 */
+					
+					meta_p = &TaskMeta[inx];
+
+					meta_p->name[0] = name[0];
+					meta_p->name[1] = name[1];
+					meta_p->name[2] = name[2];
+					meta_p->name[3] = name[3];
+					tcb_p->prio = prio;
+					meta_p->bprio = prio;
+					meta_p->sstacksize = sstack;
+					meta_p->ustacksize = ustack;
+					meta_p->flags = flags;
+
+					/*
+					 * no cores named means any core
+					 */
+
+					tcb_p->affinity = (T_CORESOF (flags) != 0) ? (T_CORESOF (flags) & CORE_ALL) : CORE_ALL;
+					tcb_p->core = core_place (tcb_p->affinity, NextCore);
+					NextCore = (tcb_p->core + 1) % NUM_CORES;
+
+					tcb_p->state = TS_CREATED;
+					tcb_p->switches = 0;
+					tcb_p->run = 0;
+
+					gxk_nm_add (NM_TASK, meta_p->name, inx);
+
+					if (flags & T_GLOBAL)
+					{
+						gxk_nd_export (NM_TASK, meta_p->name, inx);
+					}
+
+					/*
+					 * return the runtime task id
+					 */
+					
+					*tid = inx;
+
+					++TotalTaskCount;
+
+					rtn = 0;
+					break;
+				}
+			}
+		}
+	}
+	else
+	{
+		rtn = ERR_NOTCB;
+	}
+
+	gxk_k_leave ();
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				t_delete
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG t_delete(ULONG tid)
+
+{
+	ULONG rtn;
+	UINT self;
+
+	rtn = 0;
+
+	if (tid < MAX_TASK)
+	{
+		gxk_k_lock ();
+
+		self = gxk_t_self ();
+
+		if (TaskList[tid].state == TS_DEAD)
+		{
+			rtn = ERR_OBJDEL;
+		}
+		else
+		{
+			/*
+			 * kill it
+			 */
+
+			rtn = stop_task ((UINT)tid, self);
+
+			if (tid == self)
+			{
+				SelfTask = MAX_TASK;
+			}
+
+			/*
+			 * clear local data for task and reset state; its stack
+			 * reservation and task slot are given back
+			 */
+			
+			gxk_nm_remove (NM_TASK, TaskMeta[tid].name, tid);
+			gxk_nd_unexport (NM_TASK, tid);
+
+			TotalStackUsed -= TaskMeta[tid].sstacksize + TaskMeta[tid].ustacksize;
+			--TotalTaskCount;
+
+			clear_gxktcb (tid);
+		}
+
+		/*
+		 * dispatch the next task; a task deleting itself never returns
+		 */
+
+		gxk_k_unlock ();
+
+		if ((rtn == 0) && (tid == self))
+		{
+			if (SelfWorker != NULL)
+			{
+				longjmp (SelfWorker->home, 1);
+			}
+
+			gxk_h_exit ();
+		}
+	}
+	else
+	{
+		rtn = ERR_OBJID;
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				t_getreg
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG t_getreg(ULONG tid, ULONG regnum, ULONG *reg_value)
+
+{
+	ULONG rtn;
+	ULONG Index;
+
+	rtn = 0;
+
+	if (tid < MAX_TASK)
+	{
+		/*
+		 * tid 0 is the calling task
+		 */
+			
+		Index = (tid == 0) ? SelfTask : tid;
+
+		if ((Index == MAX_TASK) || (TaskList[Index].state == TS_DEAD))
+		{
+			rtn = ERR_OBJDEL;
+		}
+		else if (regnum >= REG_CNT)
+		{
+			rtn = ERR_REGNUM;
+		}
+		else
+		{
+			*reg_value = TaskMeta[Index].reg[regnum];
+			rtn = 0;
+		}
+	}
+	else
+	{
+		rtn = ERR_OBJID;
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				t_ident
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG t_ident(char name[4], ULONG node, ULONG *tid)
+
+{
+	ULONG rtn;
+
+	rtn = ERR_OBJNF;
+
+	/*
+	 * if name parameter is NULL, get ID of current thread
+	 */
+	
+	if (name == 0)
+	{
+		if (SelfTask < MAX_TASK)
+		{
+			rtn = 0;
+			*tid = SelfTask;
+		}
+	}
+	else
+	{
+		/*
+		 * otherwise, get ID of specified thread
+		 */
+		
+		rtn = gxk_nd_ident (NM_TASK, name, node, tid);
+	}
+	
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				t_info
+*
+* Type:				Function
+*
+* Description:		snapshot the run time statistics of a task
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG t_info(ULONG tid, struct tinfo *info)
+
+{
+	ULONG rtn;
+	LONGLONG run;
+	LONGLONG freq;
+	GXKTCB *tcb_p;
+
+	rtn = 0;
+
+	if (tid < MAX_TASK)
+	{
+		gxk_k_lock ();
+
+		tcb_p = &TaskList[tid];
+
+		if (tcb_p->state == TS_DEAD)
+		{
+			rtn = ERR_OBJDEL;
+		}
+		else
+		{
+			/*
+			 * a task on a core now is charged up to the call
+			 */
+
+			run = tcb_p->run;
+
+			if (core_running ((UINT)tid) < NUM_CORES)
+			{
+				run += gxk_h_clock () - tcb_p->since;
+			}
+
+			freq = gxk_h_freq ();
+
+			info->prio = tcb_p->prio;
+			info->runtime = (ULONG)(((run / freq) * 1000) + (((run % freq) * 1000) / freq));
+			info->switches = tcb_p->switches;
+		}
+
+		gxk_k_leave ();
+	}
+	else
+	{
+		rtn = ERR_OBJID;
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				t_mode
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG t_mode(ULONG mask, ULONG new_mode, ULONG *old_mode)
+
+{
+	GXKTCB *tcb_p;
+
+	gxk_k_lock ();
+
+	if (SelfTask < MAX_TASK)
+	{
+		tcb_p = &TaskList[SelfTask];
+
+		*old_mode = tcb_p->mode;
+
+		/*
+		 * only the supported mode bits can be changed, and each one
+		 * selected by mask is set or cleared as given in new_mode
+		 */
+
+		mask &= (T_NOPREEMPT | T_TSLICE | T_NOASR | T_NOISR);
+
+		tcb_p->mode = (tcb_p->mode & ~mask) | (new_mode & mask);
+
+		if (tcb_p->mode & T_TSLICE)
+		{
+			gxk_tm_slice ();
+		}
+	}
+	else
+	{
+		*old_mode = 0;
+	}
+
+	/*
+	 * becoming preemptible may hand the CPU to a waiting task
+	 */
+
+	gxk_k_unlock ();
+
+	return (0);		/* always returns 0 */
+}
+
+/******************************************************************************
+*						  
+* Name:				t_restart
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG t_restart(ULONG tid, ULONG targs[])
+
+{
+	ULONG rtn;
+	UINT self;
+	UINT inx;
+
+	rtn = 0;
+
+	if (tid < MAX_TASK)
+	{
+		gxk_k_lock ();
+
+		self = gxk_t_self ();
+
+		if (TaskList[tid].state == TS_DEAD)
+		{
+			rtn = ERR_OBJDEL;
+		}
+		else if (TaskList[tid].state == TS_CREATED)
+		{
+			rtn = ERR_NACTIVE;
+		}
+		else
+		{
+			/*
+			 * kill task, keeping mode, entry point and (unless new
+			 * ones are given) the startup arguments
+			 */
+
+			stop_task ((UINT)tid, self);
+			TaskList[tid].state = TS_CREATED;
+
+			if (tid == self)
+			{
+				SelfTask = MAX_TASK;
+			}
+
+			if (targs != NULL)
+			{
+				for (inx = 0; inx < 4; inx++)
+				{
+					TaskMeta[tid].targs[inx] = targs[inx];
+				}
+			}
+
+			/*
+			 * start task
+			 */
+			
+			rtn = start_task ((UINT)tid);
+		}
+
+		gxk_k_unlock ();
+
+		/*
+		 * a task restarting itself continues on the worker it was
+		 * handed to; this one goes back to the pool
+		 */
+
+		if (tid == self)
+		{
+			if (SelfWorker != NULL)
+			{
+				longjmp (SelfWorker->home, 1);
+			}
+
+			gxk_h_exit ();
+		}
+	}
+	else
+	{
+		rtn = ERR_OBJID;
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				t_resume
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG t_resume(ULONG tid)
+
+{
+	ULONG rtn;
+
+	rtn = 0;
+
+	if (tid < MAX_TASK)
+	{
+		gxk_k_lock ();
+
+		if (TaskList[tid].state == TS_DEAD)
+		{
+			rtn = ERR_OBJDEL;
+		}
+		else if (TaskList[tid].state != TS_SUSPEND)
+		{
+			rtn = ERR_NOTSUSP;
+		}
+		else
+		{
+			/*
+			 * a task suspended while blocked goes back to waiting,
+			 * otherwise it becomes ready
+			 */
+
+			if (TaskList[tid].pend)
+			{
+				TaskList[tid].state = TS_BLOCKED;
+			}
+			else
+			{
+				TaskList[tid].state = TS_RUNNING;
+				ready_insert ((UINT)tid, FALSE);
+			}
+
+			rtn = 0;
+		}
+
+		gxk_k_unlock ();
+	}
+	else
+	{
+		rtn = ERR_OBJID;
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				t_setaffinity
+*
+* Type:				Function
+*
+* Description:		set the cores a task may run on
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG t_setaffinity(ULONG tid, ULONG mask, ULONG *old_mask)
+
+{
+	ULONG rtn;
+	GXKTCB *tcb_p;
+
+	rtn = 0;
+
+	if (tid < MAX_TASK)
+	{
+		gxk_k_lock ();
+
+		/*
+		 * tid 0 is the calling task
+		 */
+
+		tcb_p = &TaskList[(tid == 0) ? gxk_t_self () : tid];
+
+		if ((tid == 0) && (gxk_t_self () >= MAX_TASK))
+		{
+			rtn = ERR_OBJID;
+		}
+		else if (tcb_p->state == TS_DEAD)
+		{
+			rtn = ERR_OBJDEL;
+		}
+		else if ((mask != 0) && ((mask & CORE_ALL) == 0))
+		{
+			rtn = ERR_NOCORE;
+		}
+		else
+		{
+			*old_mask = tcb_p->affinity;
+
+			tcb_p->affinity = (mask != 0) ? (UINT)(mask & CORE_ALL) : CORE_ALL;
+
+			/*
+			 * a task off its allowed cores moves now; if it is running
+			 * the scheduler takes it off its old core on the way out
+			 */
+
+			if ((tcb_p->affinity & (1U << tcb_p->core)) == 0)
+			{
+				if (tcb_p->state == TS_RUNNING)
+				{
+					ready_remove ((UINT)(tcb_p - TaskList));
+					tcb_p->core = core_place (tcb_p->affinity, tcb_p->core);
+					ready_insert ((UINT)(tcb_p - TaskList), FALSE);
+				}
+				else
+				{
+					tcb_p->core = core_place (tcb_p->affinity, tcb_p->core);
+				}
+			}
+		}
+
+		gxk_k_unlock ();
+	}
+	else
+	{
+		rtn = ERR_OBJID;
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				t_setperiod
+*
+* Type:				Function
+*
+* Description:		declare a task periodic, or no longer periodic
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG t_setperiod(ULONG tid, ULONG period, ULONG deadline, ULONG cost)
+
+{
+	ULONG rtn;
+	ULONG prio;
+	ULONG inherit;
+	UINT self;
+	GXKTCB *tcb_p;
+	GXKTMETA *meta_p;
+
+	rtn = 0;
+
+	/*
+	 * times are in ticks; a deadline of 0 is the period.  the first
+	 * job is released now and tm_wkperiod waits for each next one.
+	 * a period of 0 gives the task back the priority it had
+	 */
+
+	if (deadline == 0)
+	{
+		deadline = period;
+	}
+
+	if (tid < MAX_TASK)
+	{
+		gxk_k_lock ();
+
+		self = gxk_t_self ();
+
+		if (tid == 0)
+		{
+			tid = self;
+		}
+
+		if (tid >= MAX_TASK)
+		{
+			rtn = ERR_OBJID;
+		}
+		else if (TaskList[tid].state == TS_DEAD)
+		{
+			rtn = ERR_OBJDEL;
+		}
+		else if ((period != 0) && ((deadline > period) || (cost == 0) || (cost > deadline)))
+		{
+			rtn = ERR_ILLTICKS;
+		}
+		else if ((period != 0) && (sched_admit ((UINT)tid, deadline, cost) == FALSE))
+		{
+			rtn = ERR_OVERLOAD;
+		}
+		else
+		{
+			tcb_p = &TaskList[tid];
+			meta_p = &TaskMeta[tid];
+
+			if ((period != 0) && (meta_p->period == 0))
+			{
+				meta_p->pprio = meta_p->bprio;
+			}
+
+			prio = (period != 0) ? PERIOD_PRIO : meta_p->pprio;
+
+			meta_p->period = period;
+			meta_p->drel = deadline;
+			meta_p->cost = cost;
+			meta_p->release = gxk_tm_now ();
+
+			/*
+			 * the deadline heap is chosen as the task is queued, so
+			 * a ready task is queued again
+			 */
+
+			if (tcb_p->state == TS_RUNNING)
+			{
+				ready_remove ((UINT)tid);
+			}
+
+			tcb_p->edf = ((SCHED_POLICY == SCHED_EDF) && (period != 0));
+			tcb_p->deadline = meta_p->release + deadline;
+
+			if (tcb_p->state == TS_RUNNING)
+			{
+				ready_insert ((UINT)tid, (core_running ((UINT)tid) < NUM_CORES));
+			}
+
+			if ((SCHED_POLICY != SCHED_FIXED) || (period == 0))
+			{
+				meta_p->bprio = prio;
+
+				inherit = gxk_mu_ceiling ((UINT)tid);
+
+				gxk_t_setprio ((UINT)tid, (inherit > prio) ? inherit : prio);
+			}
+
+			if (SCHED_POLICY == SCHED_RM)
+			{
+				sched_rm ();
+			}
+		}
+
+		gxk_k_unlock ();
+	}
+	else
+	{
+		rtn = ERR_OBJID;
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				t_setpri
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG t_setpri(ULONG tid, ULONG newprio, ULONG *oldprio)
+
+{
+	ULONG rtn;
+	ULONG inherit;
+
+	rtn = 0;
+
+	if (tid < MAX_TASK)
+	{
+		gxk_k_lock ();
+
+		/*
+		 * return the priority last set; a priority inherited
+		 * through a mutex is not the task's own
+		 */
+
+		*oldprio = TaskMeta[tid].bprio;
+
+		if (TaskList[tid].state == TS_DEAD)
+		{
+			rtn = ERR_OBJDEL;
+		}
+		else if ((newprio < MIN_PRIO) || (newprio > MAX_PRIO))
+		{
+			rtn = ERR_SETPRI;
+		}
+		else
+		{
+			TaskMeta[tid].bprio = newprio;
+
+			inherit = gxk_mu_ceiling ((UINT)tid);
+
+			gxk_t_setprio ((UINT)tid, (inherit > newprio) ? inherit : newprio);
+
+			rtn = 0;
+		}
+
+		gxk_k_unlock ();
+	}
+	else
+	{
+		rtn = ERR_OBJID;
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				t_setreg
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG t_setreg(ULONG tid, ULONG regnum, ULONG reg_value)
+
+{
+	ULONG rtn;
+	GXKTCB *pTcb;
+	GXKTMETA *pMeta;
+
+	rtn = 0;
+
+	if (tid < MAX_TASK)
+	{
+		if ((tid == 0) && (SelfTask == MAX_TASK))
+		{
+			/*
+			 * only used to associate host tid with our tid
+			 * for threads not started by t_start;
+			 * reg_value was our TCB index when thread was created
+			 */
+
+			if (reg_value < MAX_TASK)
+			{
+				TaskThread[reg_value] = gxk_h_threadid ();
+				SelfTask = (UINT)reg_value;
+			}
+			rtn = 0;
+		}
+		else
+		{
+			/*
+			 * tid 0 is the calling task
+			 */
+
+			pTcb = &TaskList[(tid == 0) ? SelfTask : tid];
+			pMeta = &TaskMeta[(tid == 0) ? SelfTask : tid];
+
+			if (pTcb->state == TS_DEAD)
+			{
+				rtn = ERR_OBJDEL;
+			}
+			else if (regnum >= REG_CNT)
+			{
+				rtn = ERR_REGNUM;
+			}
+			else
+			{
+				pMeta->reg[regnum] = reg_value;
+				rtn = 0;
+			}
+		}
+	}
+	else
+	{
+		rtn = ERR_OBJID;
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				t_start
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG t_start(ULONG tid, ULONG mode, void (*start_addr)(), ULONG targs[])
+
+{
+	ULONG rtn;
+	GXKTCB *tcb_p;
+	UINT inx;
+
+	rtn = 0;
+
+	if (tid < MAX_TASK)
+	{
+		gxk_k_lock ();
+
+		tcb_p = &TaskList[tid];
+
+		if (tcb_p->state == TS_DEAD)
+		{
+			rtn = ERR_OBJDEL;
+		}
+		else if (tcb_p->state != TS_CREATED)
+		{
+			rtn = ERR_ACTIVE;
+		}
+		else
+		{
+			/*
+			 * init startup data; the arguments are copied since the
+			 * caller's array need not outlive this call
+			 */
+
+			tcb_p->mode = mode;
+			TaskMeta[tid].start_addr = start_addr;
+
+			for (inx = 0; inx < 4; inx++)
+			{
+				TaskMeta[tid].targs[inx] = (targs != NULL) ? targs[inx] : 0;
+			}
+			
+			/*
+			 * start the task
+			 */
+			
+			rtn = start_task ((UINT)tid);
+		}
+
+		/*
+		 * the new task runs now if it outranks the caller
+		 */
+
+		gxk_k_unlock ();
+	}
+	else
+	{
+		rtn = ERR_OBJID;
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				t_suspend
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG t_suspend(ULONG tid)
+
+{
+	ULONG rtn;
+
+	rtn = 0;
+
+	if (tid < MAX_TASK)
+	{
+		gxk_k_lock ();
+
+		if (TaskList[tid].state == TS_DEAD)
+		{
+			rtn = ERR_OBJDEL;
+		}
+		else if (TaskList[tid].state == TS_SUSPEND)
+		{
+			rtn = ERR_SUSP;
+		}
+		else if (TaskList[tid].state == TS_CREATED)
+		{
+			rtn = ERR_NACTIVE;
+		}
+		else
+		{
+			/*
+			 * take the task off the ready queue and update state; a
+			 * blocked task stays on its wait queue
+			 */
+
+			if (TaskList[tid].state == TS_RUNNING)
+			{
+				ready_remove ((UINT)tid);
+			}
+
+			TaskList[tid].state = TS_SUSPEND;
+
+			rtn = 0;
+		}
+
+		/*
+		 * a task suspending itself gives up the CPU here
+		 */
+
+		gxk_k_unlock ();
+	}
+	else
+	{
+		rtn = ERR_OBJID;
+	}
+
+	return (rtn);
+}
+
+
+/******************************************************************************
+*						  
+* Name:				gxk_t_getTid
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_t_getTid(unsigned threadid, ULONG *tid)
+
+{
+	ULONG rtn;
+	UINT inx;
+
+	/*
+	 * the calling thread is the usual case and needs no search
+	 */
+
+	if ((SelfTask < MAX_TASK) && (TaskThread[SelfTask] == threadid))
+	{
+		*tid = SelfTask;
+		return (0);
+	}
+
+	rtn = 1;
+
+	for (inx = 0; inx < MAX_TASK; inx++)
+	{
+		if (TaskThread[inx] == threadid)
+		{
+			*tid = inx;
+			rtn = 0;
+			break;
+		}
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_t_self
+*
+* Type:				Function
+*
+* Description:		task id of the calling thread, MAX_TASK if not a task
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+UINT gxk_t_self(void)
+
+{
+	return (SelfTask);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_t_setprio
+*
+* Type:				Function
+*
+* Description:		change the priority a task is scheduled at
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_t_setprio(UINT tid, ULONG prio)
+
+{
+	GXKWAITQ *wq;
+	GXKTCB *tcb_p;
+
+	/*
+	 * called with the kernel locked, by t_setpri and to raise or
+	 * drop a mutex owner's inherited priority
+	 */
+
+	tcb_p = &TaskList[tid];
+
+	if (tcb_p->prio == prio)
+	{
+		return;
+	}
+
+	if (tcb_p->state == TS_RUNNING)
+	{
+		/*
+		 * requeue at the new level; the running task stays at the
+		 * head so it is not rotated behind its peers
+		 */
+
+		ready_remove (tid);
+		tcb_p->prio = prio;
+		ready_insert (tid, (core_running (tid) < NUM_CORES));
+	}
+	else if ((tcb_p->waitq != NULL) && (tcb_p->waitq->prior))
+	{
+		/* keep a priority ordered wait queue in order */
+		wq = tcb_p->waitq;
+
+		waitq_remove (tid);
+		tcb_p->prio = prio;
+		waitq_insert (wq, tid);
+	}
+	else
+	{
+		tcb_p->prio = prio;
+	}
+
+	gxk_h_setprio (TaskMeta[tid].thread, prio);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_t_base
+*
+* Type:				Function
+*
+* Description:		priority of a task without inheritance
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_t_base(UINT tid)
+
+{
+	return (TaskMeta[tid].bprio);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_t_prio
+*
+* Type:				Function
+*
+* Description:		priority a task is scheduled at
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_t_prio(UINT tid)
+
+{
+	return (TaskList[tid].prio);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_t_mode
+*
+* Type:				Function
+*
+* Description:		mode bits a task runs with
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_t_mode(UINT tid)
+
+{
+	return (TaskList[tid].mode);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_t_release
+*
+* Type:				Function
+*
+* Description:		advance a periodic task to its next job
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_t_release(UINT tid, ULONG *release)
+
+{
+	ULONG rtn;
+	GXKTCB *tcb_p;
+	GXKTMETA *meta_p;
+
+	rtn = 0;
+
+	/*
+	 * called with the kernel locked by tm_wkperiod; the next job's
+	 * deadline is set now, so a task that waits loses its place on
+	 * the deadline heap to the jobs due before it
+	 */
+
+	tcb_p = &TaskList[tid];
+	meta_p = &TaskMeta[tid];
+
+	if (meta_p->period == 0)
+	{
+		rtn = ERR_NOPERIOD;
+	}
+	else
+	{
+		meta_p->release += meta_p->period;
+
+		if (tcb_p->hpos != NO_HEAP)
+		{
+			ready_remove (tid);
+			tcb_p->deadline = meta_p->release + meta_p->drel;
+			ready_insert (tid, FALSE);
+		}
+		else
+		{
+			tcb_p->deadline = meta_p->release + meta_p->drel;
+		}
+
+		*release = meta_p->release;
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_t_sched
+*
+* Type:				Function
+*
+* Description:		dispatch the highest priority ready task
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_t_sched(void)
+
+{
+	UINT core;
+	UINT self;
+	UINT cur;
+	UINT next;
+	UINT steal;
+	ULONG park;
+
+	/*
+	 * called with the kernel locked; returns TRUE when the calling
+	 * task has lost the CPU and must park once it leaves the kernel
+	 */
+
+	park = FALSE;
+	self = gxk_t_self ();
+
+	/*
+	 * a caller that lost the CPU in its body parks now
+	 */
+
+	if ((self < MAX_TASK) && TaskList[self].preempted)
+	{
+		TaskList[self].preempted = FALSE;
+		park = TRUE;
+	}
+
+	/*
+	 * a running task moved to another core's queue by t_setaffinity
+	 * first leaves the core it is on, so no task is current twice
+	 */
+
+	for (core = 0; (NUM_CORES > 1) && (core < NUM_CORES); core++)
+	{
+		cur = Cores[core].current;
+
+		if ((cur < MAX_TASK) && (TaskList[cur].core != core))
+		{
+			Cores[core].current = MAX_TASK;
+
+			sched_charge (cur, MAX_TASK);
+
+			if (cur == self)
+			{
+				park = TRUE;
+			}
+			else
+			{
+				stop_thread (cur);
+			}
+		}
+	}
+
+	for (core = 0; core < NUM_CORES; core++)
+	{
+		cur = Cores[core].current;
+
+		if ((cur < MAX_TASK) && (TaskList[cur].state == TS_RUNNING) &&
+			(TaskList[cur].mode & T_NOPREEMPT))
+		{
+			next = cur;
+		}
+		else
+		{
+			next = ready_highest (core);
+
+			if ((NUM_CORES > 1) && CORE_STEAL)
+			{
+				steal = core_steal (core, (next < MAX_TASK) ? TaskList[next].prio : 0);
+
+				if (steal < MAX_TASK)
+				{
+					next = steal;
+				}
+			}
+		}
+
+		if (next != cur)
+		{
+			GXK_TRACE (TR_SWITCH, core, (cur < MAX_TASK) ? cur : TR_NONE, (next < MAX_TASK) ? next : TR_NONE);
+
+			Cores[core].current = next;
+
+			sched_charge (cur, next);
+
+			if (cur < MAX_TASK)
+			{
+				/*
+				 * the caller yields the CPU itself, anyone else
+				 * at its next kernel exit
+				 */
+
+				if (cur == self)
+				{
+					park = TRUE;
+				}
+				else
+				{
+					stop_thread (cur);
+				}
+			}
+
+			if (next < MAX_TASK)
+			{
+				/*
+				 * dispatched again before it parked; it finds itself
+				 * current and carries on
+				 */
+
+				if (next == self)
+				{
+					park = TRUE;
+				}
+
+				/*
+				 * each dispatch starts a fresh quantum
+				 */
+
+				TaskList[next].slice = TSLICE_TICKS;
+
+				if (TaskList[next].mode & T_TSLICE)
+				{
+					gxk_tm_slice ();
+				}
+
+				start_thread (next);
+			}
+		}
+	}
+
+	/*
+	 * a caller that is to park is out of its body from here on
+	 */
+
+	if (park && (self < MAX_TASK))
+	{
+		TaskList[self].body = FALSE;
+	}
+
+	return (park);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_t_tick
+*
+* Type:				Function
+*
+* Description:		charge a clock tick to the time-sliced tasks running
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+UINT gxk_t_tick(void)
+
+{
+	UINT core;
+	UINT cur;
+	UINT rtn;
+	GXKTCB *tcb_p;
+
+	rtn = FALSE;
+
+	/*
+	 * called with the kernel locked on every tick.  a running T_TSLICE
+	 * task that spends its quantum goes to the tail of its priority
+	 * list, and leaving the kernel dispatches the next task of that
+	 * priority.  tasks on the deadline heap are ordered by deadline
+	 * and are not sliced.  returns TRUE while any core runs a
+	 * time-sliced task, so the clock keeps ticking for it
+	 */
+
+	for (core = 0; core < NUM_CORES; core++)
+	{
+		if ((cur = Cores[core].current) < MAX_TASK)
+		{
+			tcb_p = &TaskList[cur];
+
+			if ((tcb_p->state == TS_RUNNING) && (tcb_p->hpos == NO_HEAP) &&
+				((tcb_p->mode & (T_TSLICE | T_NOPREEMPT)) == T_TSLICE))
+			{
+				rtn = TRUE;
+
+				if ((tcb_p->slice == 0) || (--tcb_p->slice == 0))
+				{
+					tcb_p->slice = TSLICE_TICKS;
+
+					/*
+					 * alone at its priority it simply starts another quantum
+					 */
+
+					if ((tcb_p->next != MAX_TASK) || (tcb_p->prev != MAX_TASK))
+					{
+						ready_remove (cur);
+						ready_insert (cur, FALSE);
+					}
+				}
+			}
+		}
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_t_park
+*
+* Type:				Function
+*
+* Description:		wait until the calling task is dispatched
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_t_park(ULONG msec)
+
+{
+	UINT self;
+	GXKTCB *tcb_p;
+	GXKEVENT gate;
+	ULONG run;
+
+	/*
+	 * called with the kernel unlocked; a finite msec bounds the
+	 * kernel wait the task is blocked in
+	 */
+
+	self = gxk_t_self ();
+
+	if (self >= MAX_TASK)
+	{
+		return;
+	}
+
+	tcb_p = &TaskList[self];
+	gate = (SelfWorker != NULL) ? SelfWorker->gate : TaskMeta[self].gate;
+
+	for (;;)
+	{
+		if (gxk_h_evwait (gate, msec) == FALSE)
+		{
+			/*
+			 * wait timed out unless woken meanwhile; either way the
+			 * task now competes for the CPU like any other
+			 */
+
+			gxk_k_lock ();
+
+			if ((SelfWorker != NULL) && SelfWorker->recall)
+			{
+				gxk_k_leave ();
+				longjmp (SelfWorker->home, 1);
+			}
+
+			if (tcb_p->pend)
+			{
+				gxk_t_ready (self, ERR_TIMEOUT);
+			}
+
+			gxk_t_sched ();
+			gxk_k_leave ();
+
+			msec = INFINITE;
+		}
+		else
+		{
+			/*
+			 * the task was deleted while parked, and its slot may
+			 * already belong to another task, so the recall is
+			 * looked at first
+			 */
+
+			gxk_k_lock ();
+
+			if ((SelfWorker != NULL) && SelfWorker->recall)
+			{
+				gxk_k_leave ();
+				longjmp (SelfWorker->home, 1);
+			}
+
+			run = (core_running (self) < NUM_CORES);
+			tcb_p->body = run;
+			gxk_k_leave ();
+
+			if (run) break;
+		}
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_t_initq
+*
+* Type:				Function
+*
+* Description:		initialize an empty wait queue
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_t_initq(GXKWAITQ *wq, UINT prior)
+
+{
+	wq->head = wq->tail = MAX_TASK;
+	wq->prior = prior;
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_t_wait
+*
+* Type:				Function
+*
+* Description:		block the calling task, optionally on a wait queue
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_t_wait(GXKWAITQ *wq, ULONG msec)
+
+{
+	UINT self;
+	GXKTCB *tcb_p;
+
+	/*
+	 * called with the kernel locked and returns with it locked;
+	 * the result is the code passed to gxk_t_ready, or ERR_TIMEOUT
+	 */
+
+	self = gxk_t_self ();
+
+	if (self >= MAX_TASK)
+	{
+		return (ERR_OBJID);
+	}
+
+	tcb_p = &TaskList[self];
+
+	tcb_p->wcode = 0;
+	tcb_p->pend = TRUE;
+
+	if (wq != NULL)
+	{
+		waitq_insert (wq, self);
+	}
+
+	ready_remove (self);
+	tcb_p->state = TS_BLOCKED;
+
+	GXK_TRACE (TR_BLOCK, self, msec, 0);
+
+	gxk_t_sched ();
+	gxk_k_leave ();
+
+	gxk_t_park (msec);
+
+	gxk_k_lock ();
+
+	return (tcb_p->wcode);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_t_ready
+*
+* Type:				Function
+*
+* Description:		end the kernel wait of a blocked task
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_t_ready(UINT tid, ULONG code)
+
+{
+	GXKTCB *tcb_p;
+
+	/*
+	 * called with the kernel locked; the preemption check against
+	 * the running task is made when the kernel is left
+	 */
+
+	tcb_p = &TaskList[tid];
+
+	if (tcb_p->pend)
+	{
+		if (tcb_p->waitq != NULL)
+		{
+			waitq_remove (tid);
+		}
+
+		tcb_p->pend = FALSE;
+		tcb_p->wcode = code;
+
+		GXK_TRACE (TR_WAKE, tid, code, 0);
+
+		/*
+		 * a suspended task stays suspended until resumed
+		 */
+
+		if (tcb_p->state == TS_BLOCKED)
+		{
+			tcb_p->state = TS_RUNNING;
+			ready_insert (tid, FALSE);
+		}
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_t_wake
+*
+* Type:				Function
+*
+* Description:		wake the first task on a wait queue
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+UINT gxk_t_wake(GXKWAITQ *wq, ULONG code)
+
+{
+	UINT tid;
+
+	tid = wq->head;
+
+	if (tid < MAX_TASK)
+	{
+		gxk_t_ready (tid, code);
+	}
+
+	return (tid);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_t_flush
+*
+* Type:				Function
+*
+* Description:		wake every task on a wait queue
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_t_flush(GXKWAITQ *wq, ULONG code)
+
+{
+	ULONG count;
+
+	count = 0;
+
+	while (gxk_t_wake (wq, code) < MAX_TASK)
+	{
+		++count;
+	}
+
+	return (count);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_t_delay
+*
+* Type:				Function
+*
+* Description:		block the calling task for a time
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_t_delay(ULONG msec)
+
+{
+	UINT self;
+
+	gxk_k_lock ();
+
+	self = gxk_t_self ();
+
+	if (self >= MAX_TASK)
+	{
+		/*
+		 * not a task, nothing to dispatch
+		 */
+
+		gxk_k_leave ();
+		gxk_h_sleep (msec);
+	}
+	else if (msec == 0)
+	{
+		/*
+		 * yield to ready tasks of the same priority
+		 */
+
+		ready_remove (self);
+		ready_insert (self, FALSE);
+
+		gxk_k_unlock ();
+	}
+	else
+	{
+		gxk_t_wait (NULL, msec);
+		gxk_k_unlock ();
+	}
+
+	return (0);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_t_init
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_t_init()
+
+{
+	UINT inx;
+	UINT core;
+
+	TotalTaskCount = 0;
+	TotalStackUsed = 0;
+
+	NextCore = 0;
+
+	for (core = 0; core < NUM_CORES; core++)
+	{
+		Cores[core].current = MAX_TASK;
+		Cores[core].group = 0;
+		Cores[core].nedf = 0;
+
+		for (inx = 0; inx < PRIO_WORDS; inx++)
+		{
+			Cores[core].map[inx] = 0;
+		}
+
+		for (inx = 0; inx < MAX_PRIO; inx++)
+		{
+			Cores[core].head[inx] = Cores[core].tail[inx] = MAX_TASK;
+		}
+	}
+
+	for (inx = 0; inx < MAX_TASK; inx++)
+	{
+		clear_gxktcb (inx);
+
+		/*
+		 * create the dispatch gate for each task slot
+		 */
+
+		if (TaskMeta[inx].gate == NULL)
+		{
+			TaskMeta[inx].gate = gxk_h_evcreate ();
+		}
+	}
+
+	/*
+	 * stock the worker pool; further threads are started as t_start
+	 * runs short of parked ones
+	 */
+
+	WorkerFree = MAX_WORKER;
+
+	for (inx = MAX_WORKER; inx-- > 0; )
+	{
+		Workers[inx].thread = NULL;
+		Workers[inx].threadid = 0;
+		Workers[inx].stack = 0;
+		Workers[inx].core = NUM_CORES;
+		Workers[inx].wake = gxk_h_evcreate ();
+		Workers[inx].gate = gxk_h_evcreate ();
+
+		if (inx < POOL_THREADS)
+		{
+			worker_spawn (inx, MAX_TSTACK);
+		}
+
+		worker_put (&Workers[inx]);
 	}
 
 	return (0);
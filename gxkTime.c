@@ -17,12 +17,35 @@
 *	tm_evwhen
 *	tm_get
 *	tm_set
+*	tm_tick
 *	tm_wkafter
+*	tm_wkperiod
 *	tm_wkwhen
 *
+*	gxk_tm_batch
+*	gxk_tm_init
+*	gxk_tm_msec
+*	gxk_tm_now
+*	gxk_tm_purge
+*	gxk_tm_slice
+*
 * Private Functions:
 *
+*	cal_date
+*	cal_days
+*	cal_ticks
+*	clock_due
+*	clock_now
+*	clock_sync
 *	gxkTmp
+*	tick_thread
+*	tmr_advance
+*	tmr_arm
+*	tmr_free
+*	tmr_place
+*	tmr_start
+*	tmr_unlink
+*	tod_target
 *
 * Modification History:
 * ----------------------------------------------------------- 
@@ -34,18 +57,90 @@
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <windows.h>
-#include <process.h>
+#include "gxkHost.h"
 #include "gxkernel.h"
 #include "gxkCfg.h"
+#include "gxkSys.h"
+
+/********************************
+		LOCAL DECLARATIONS
+********************************/
+
+/*
+ * armed timers hang on a four level hierarchical wheel of 64 slots
+ * per level.  level 0 holds timers due within 64 ticks, one slot per
+ * tick; each higher level covers 64 times the span of the one below
+ * and is cascaded down a slot at a time as the level below wraps.
+ * slot lists are doubly linked through the timer table, so arming
+ * and cancelling are O(1)
+ */
+
+#define WHEEL_BITS			6
+#define WHEEL_SIZE			(1 << WHEEL_BITS)
+#define WHEEL_MASK			(WHEEL_SIZE - 1)
+#define WHEEL_LEVELS		4
+#define WHEEL_SPAN			(1UL << (WHEEL_BITS * WHEEL_LEVELS))
+
+#define NO_TMR				MAX_TIMER
+
+/*
+ * the kernel clock counts ticks since gxk_tm_init off the monotonic
+ * host clock; the calendar kept by tm_set/tm_get is the same count
+ * offset to ticks since 1/1/1970
+ */
+
+#define TICKS_SEC			(1000 / TICK_MSEC)
+#define CAL_EPOCH			1970
+#define CAL_LEAP(y)			((((y) % 4) == 0) && ((((y) % 100) != 0) || (((y) % 400) == 0)))
+
+#if ((1000 % TICK_MSEC) != 0)
+#error TICK_MSEC must divide a second
+#endif
+
+#if (MAX_TIMER > 0x10000)
+#error MAX_TIMER must fit the 16 bit index of a tmid
+#endif
+
+typedef struct
+{
+	ULONG tid;					/* task the events go to */
+	ULONG events;
+	ULONG expires;				/* absolute tick */
+	ULONG period;				/* reload, 0 = one shot */
+	UINT used;
+	UINT gen;					/* reuse count, high half of the tmid */
+	UINT slot;					/* wheel slot, NO_TMR when not armed */
+	UINT next;
+	UINT prev;
+} TMDESC;
+
+/********************************
+		GLOBALS
+********************************/
+
+TMDESC TmTbl[MAX_TIMER];
+UINT Wheel[WHEEL_LEVELS * WHEEL_SIZE];
+UINT TmFree;
+UINT TmArmed;
+UINT TmSliced;						/* a T_TSLICE task ran at the last tick */
+UINT TmBatch;						/* remote calls wait for the next tick */
+volatile ULONG TickCount;
+
+LONGLONG ClockBase;				/* counter at gxk_tm_init */
+LONGLONG ClockFreq;
+LONGLONG TodBase;					/* calendar tick at clock tick 0 */
+BOOL TodSet;
+GXKEVENT ClockEvent;					/* wakes an idle tick_thread */
+
+UCHAR CalDays[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
 
 /******************************************************************************
 *						  
-* Name:				tm_cancel
+* Name:				clock_now
 *
 * Type:				Function
 *
-* Description:		
+* Description:		ticks since gxk_tm_init, read from the host clock
 * 
 * Formal Inputs:	
 *
@@ -60,20 +155,29 @@
 * Author:			GVH
 *
 ******************************************************************************/
-		  
-ULONG tm_cancel(ULONG tmid)
+
+static LONGLONG clock_now(void)
 
 {
-	return (0);
+	LONGLONG elapsed;
+
+	elapsed = gxk_h_clock () - ClockBase;
+
+	/*
+	 * whole seconds and the remainder are scaled apart so a long
+	 * uptime cannot overflow the product
+	 */
+
+	return (((elapsed / ClockFreq) * TICKS_SEC) + (((elapsed % ClockFreq) * TICKS_SEC) / ClockFreq));
 }
 
 /******************************************************************************
 *						  
-* Name:				tm_evafter
+* Name:				clock_due
 *
 * Type:				Function
 *
-* Description:		
+* Description:		milliseconds until the clock reaches a tick, 0 once it has
 * 
 * Formal Inputs:	
 *
@@ -89,19 +193,29 @@ ULONG tm_cancel(ULONG tmid)
 *
 ******************************************************************************/
 
-ULONG tm_evafter(ULONG ticks, ULONG events, ULONG *tmid)
+static DWORD clock_due(LONGLONG tick)
 
 {
-	return (0);
+	LONGLONG due;
+
+	due = ClockBase + ((tick / TICKS_SEC) * ClockFreq) +
+		((((tick % TICKS_SEC) * ClockFreq) + TICKS_SEC - 1) / TICKS_SEC);
+	due -= gxk_h_clock ();
+
+	/*
+	 * round up, so a wait never returns short of the tick
+	 */
+
+	return ((due <= 0) ? 0 : (DWORD)(((due * 1000) + ClockFreq - 1) / ClockFreq));
 }
 
 /******************************************************************************
 *						  
-* Name:				tm_evevery
+* Name:				clock_sync
 *
 * Type:				Function
 *
-* Description:		
+* Description:		bring the wheel count up to the clock while no timer is armed
 * 
 * Formal Inputs:	
 *
@@ -117,19 +231,30 @@ ULONG tm_evafter(ULONG ticks, ULONG events, ULONG *tmid)
 *
 ******************************************************************************/
 
-ULONG tm_evevery(ULONG ticks, ULONG events, ULONG *tmid)
+static void clock_sync(void)
 
 {
-	return (0);
+#if TICK_THREAD
+	/*
+	 * an idle wheel lets tick_thread sleep without ticking, so the
+	 * count is caught up before a timer is armed against it; with
+	 * nothing on the wheel there is nothing to cascade
+	 */
+
+	if (TmArmed == 0)
+	{
+		TickCount = (ULONG)clock_now ();
+	}
+#endif
 }
 
 /******************************************************************************
 *						  
-* Name:				tm_evwhen
+* Name:				cal_days
 *
 * Type:				Function
 *
-* Description:		
+* Description:		days from 1/1/1970 to a calendar date
 * 
 * Formal Inputs:	
 *
@@ -145,19 +270,36 @@ ULONG tm_evevery(ULONG ticks, ULONG events, ULONG *tmid)
 *
 ******************************************************************************/
 
-ULONG tm_evwhen(ULONG date, ULONG time, ULONG ticks, ULONG events, ULONG *tmid)
+static ULONG cal_days(ULONG year, ULONG month, ULONG day)
 
 {
-	return (0);
+	ULONG era;
+	ULONG yoe;
+	ULONG doy;
+
+	/*
+	 * count from March so the leap day falls at the end of the year
+	 */
+
+	if (month <= 2)
+	{
+		year--;
+	}
+
+	era = year / 400;
+	yoe = year - (era * 400);
+	doy = (((153 * ((month > 2) ? (month - 3) : (month + 9))) + 2) / 5) + day - 1;
+
+	return ((era * 146097) + (yoe * 365) + (yoe / 4) - (yoe / 100) + doy - 719468);
 }
 
 /******************************************************************************
 *						  
-* Name:				tm_get
+* Name:				cal_ticks
 *
 * Type:				Function
 *
-* Description:		
+* Description:		pack a pSOS date, time and ticks into a calendar tick
 * 
 * Formal Inputs:	
 *
@@ -173,23 +315,60 @@ ULONG tm_evwhen(ULONG date, ULONG time, ULONG ticks, ULONG events, ULONG *tmid)
 *
 ******************************************************************************/
 
-ULONG tm_get(ULONG *date, ULONG *time, ULONG *ticks)
+static ULONG cal_ticks(ULONG date, ULONG time, ULONG ticks, LONGLONG *tod)
 
 {
-	*date = 0x07d1090b;
-	*time = 0x00083600;
-	*ticks = 0;
-	
-	return (0);
+	ULONG rtn;
+	ULONG year;
+	ULONG month;
+	ULONG day;
+	ULONG hour;
+	ULONG min;
+	ULONG sec;
+
+	rtn = 0;
+
+	/*
+	 * date is year:16 month:8 day:8, time is hour:16 minute:8 second:8
+	 */
+
+	year = date >> 16;
+	month = (date >> 8) & 0xFF;
+	day = date & 0xFF;
+
+	hour = time >> 16;
+	min = (time >> 8) & 0xFF;
+	sec = time & 0xFF;
+
+	if ((year < CAL_EPOCH) || (month < 1) || (month > 12) || (day < 1) ||
+		(day > (ULONG)(CalDays[month - 1] + (((month == 2) && CAL_LEAP (year)) ? 1 : 0))))
+	{
+		rtn = ERR_ILLDATE;
+	}
+	else if ((hour > 23) || (min > 59) || (sec > 59))
+	{
+		rtn = ERR_ILLTIME;
+	}
+	else if (ticks >= TICKS_SEC)
+	{
+		rtn = ERR_ILLTICKS;
+	}
+	else
+	{
+		*tod = (((((((LONGLONG)cal_days (year, month, day) * 24) + hour) * 60) + min) * 60) + sec) * TICKS_SEC;
+		*tod += ticks;
+	}
+
+	return (rtn);
 }
 
 /******************************************************************************
 *						  
-* Name:				tm_set
+* Name:				cal_date
 *
 * Type:				Function
 *
-* Description:		
+* Description:		unpack a calendar tick into a pSOS date, time and ticks
 * 
 * Formal Inputs:	
 *
@@ -205,19 +384,50 @@ ULONG tm_get(ULONG *date, ULONG *time, ULONG *ticks)
 *
 ******************************************************************************/
 
-ULONG tm_set(ULONG date, ULONG time, ULONG ticks)
+static void cal_date(LONGLONG tod, ULONG *date, ULONG *time, ULONG *ticks)
 
 {
-	return (0);
+	ULONG secs;
+	ULONG days;
+	ULONG era;
+	ULONG doe;
+	ULONG yoe;
+	ULONG doy;
+	ULONG mp;
+	ULONG year;
+	ULONG month;
+
+	*ticks = (ULONG)(tod % TICKS_SEC);
+
+	days = (ULONG)((tod / TICKS_SEC) / 86400);
+	secs = (ULONG)((tod / TICKS_SEC) % 86400);
+
+	*time = ((secs / 3600) << 16) | (((secs / 60) % 60) << 8) | (secs % 60);
+
+	/*
+	 * inverse of cal_days
+	 */
+
+	days += 719468;
+	era = days / 146097;
+	doe = days - (era * 146097);
+	yoe = (doe - (doe / 1460) + (doe / 36524) - (doe / 146096)) / 365;
+	doy = doe - ((yoe * 365) + (yoe / 4) - (yoe / 100));
+	mp = ((doy * 5) + 2) / 153;
+
+	month = (mp < 10) ? (mp + 3) : (mp - 9);
+	year = yoe + (era * 400) + ((month <= 2) ? 1 : 0);
+
+	*date = (year << 16) | (month << 8) | (doy - (((153 * mp) + 2) / 5) + 1);
 }
 
 /******************************************************************************
 *						  
-* Name:				tm_wkafter
+* Name:				tod_target
 *
 * Type:				Function
 *
-* Description:		
+* Description:		clock tick a calendar date and time falls on
 * 
 * Formal Inputs:	
 *
@@ -233,21 +443,41 @@ ULONG tm_set(ULONG date, ULONG time, ULONG ticks)
 *
 ******************************************************************************/
 
-ULONG tm_wkafter(ULONG ticks)
+static ULONG tod_target(ULONG date, ULONG time, ULONG ticks, LONGLONG *tick)
 
 {
-	Sleep (ticks * 10);
+	ULONG rtn;
+	LONGLONG tod;
 
-	return (0);
+	if (TodSet == FALSE)
+	{
+		rtn = ERR_NOTIME;
+	}
+	else if ((rtn = cal_ticks (date, time, ticks, &tod)) == 0)
+	{
+		*tick = tod - TodBase;
+
+		if (*tick <= clock_now ())
+		{
+			rtn = ERR_TOOLATE;
+		}
+		else if ((*tick - clock_now ()) >= 0x80000000)
+		{
+			/* beyond what the 32 bit tick count can arm */
+			rtn = ERR_ILLDATE;
+		}
+	}
+
+	return (rtn);
 }
 
 /******************************************************************************
 *						  
-* Name:				tm_wkwhen
+* Name:				tmr_unlink
 *
 * Type:				Function
 *
-* Description:		
+* Description:		take an armed timer off its wheel slot
 * 
 * Formal Inputs:	
 *
@@ -263,14 +493,1130 @@ ULONG tm_wkafter(ULONG ticks)
 *
 ******************************************************************************/
 
-ULONG tm_wkwhen(ULONG date, ULONG time, ULONG ticks)
+static void tmr_unlink(UINT inx)
+
+{
+	TMDESC *tm_p;
+
+	tm_p = &TmTbl[inx];
+
+	if (tm_p->prev == NO_TMR)
+	{
+		Wheel[tm_p->slot] = tm_p->next;
+	}
+	else
+	{
+		TmTbl[tm_p->prev].next = tm_p->next;
+	}
+
+	if (tm_p->next != NO_TMR)
+	{
+		TmTbl[tm_p->next].prev = tm_p->prev;
+	}
+
+	tm_p->slot = NO_TMR;
+}
+
+/******************************************************************************
+*						  
+* Name:				tmr_place
+*
+* Type:				Function
+*
+* Description:		put a timer on the wheel slot for its expiry
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void tmr_place(UINT inx)
 
 {
+	TMDESC *tm_p;
+	ULONG delta;
+	ULONG when;
+	UINT lvl;
+
+	tm_p = &TmTbl[inx];
+
 	/*
-	 * not keeping clock, so make it in 10 seconds
+	 * pick the lowest level whose span covers the wait; a wait beyond
+	 * the whole wheel parks in the top level and is placed again when
+	 * that slot cascades
 	 */
-	
-	Sleep (10000);
 
-	return (0);
+	delta = tm_p->expires - TickCount;
+	when = (delta < WHEEL_SPAN) ? tm_p->expires : (TickCount + WHEEL_SPAN - 1);
+
+	for (lvl = 0; lvl < (WHEEL_LEVELS - 1); lvl++)
+	{
+		if (delta < (1UL << (WHEEL_BITS * (lvl + 1)))) break;
+	}
+
+	tm_p->slot = (lvl * WHEEL_SIZE) + ((when >> (WHEEL_BITS * lvl)) & WHEEL_MASK);
+	tm_p->prev = NO_TMR;
+	tm_p->next = Wheel[tm_p->slot];
+
+	if (tm_p->next != NO_TMR)
+	{
+		TmTbl[tm_p->next].prev = inx;
+	}
+
+	Wheel[tm_p->slot] = inx;
+}
+
+/******************************************************************************
+*						  
+* Name:				tmr_free
+*
+* Type:				Function
+*
+* Description:		return a timer to the free list
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void tmr_free(UINT inx)
+
+{
+	if (TmTbl[inx].used)
+	{
+		TmArmed--;
+	}
+
+	TmTbl[inx].used = FALSE;
+	TmTbl[inx].next = TmFree;
+
+	TmFree = inx;
+}
+
+/******************************************************************************
+*						  
+* Name:				tmr_start
+*
+* Type:				Function
+*
+* Description:		arm a timer for the calling task
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static ULONG tmr_start(ULONG delay, ULONG period, ULONG events, ULONG *tmid)
+
+{
+	ULONG rtn;
+	UINT inx;
+	UINT self;
+	TMDESC *tm_p;
+
+	rtn = 0;
+
+	self = gxk_t_self ();
+
+	if (self >= MAX_TASK)
+	{
+		rtn = ERR_OBJID;
+	}
+	else if (TmFree == NO_TMR)
+	{
+		rtn = ERR_NOTIMERS;
+	}
+	else
+	{
+		clock_sync ();
+
+		inx = TmFree;
+		tm_p = &TmTbl[inx];
+
+		TmFree = tm_p->next;
+
+		tm_p->used = TRUE;
+		tm_p->gen = (tm_p->gen + 1) & 0xFFFF;
+		tm_p->tid = self;
+		tm_p->events = events;
+		tm_p->expires = TickCount + delay;
+		tm_p->period = period;
+
+		tmr_place (inx);
+
+		*tmid = ((ULONG)tm_p->gen << 16) | inx;
+
+		/*
+		 * the first timer on an idle wheel restarts the tick
+		 */
+
+#if TICK_THREAD
+		if (TmArmed++ == 0)
+		{
+			gxk_h_evset (ClockEvent);
+		}
+#else
+		TmArmed++;
+#endif
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				tmr_advance
+*
+* Type:				Function
+*
+* Description:		advance the wheel one tick and fire the timers due
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static void tmr_advance(void)
+
+{
+	UINT lvl;
+	UINT inx;
+	UINT next;
+	ULONG now;
+	TMDESC *tm_p;
+
+	now = ++TickCount;
+
+	/*
+	 * each time a level wraps to slot 0, the next level's current
+	 * slot is spread over the levels below
+	 */
+
+	for (lvl = 1; lvl < WHEEL_LEVELS; lvl++)
+	{
+		if (((now >> (WHEEL_BITS * (lvl - 1))) & WHEEL_MASK) != 0) break;
+
+		inx = Wheel[(lvl * WHEEL_SIZE) + ((now >> (WHEEL_BITS * lvl)) & WHEEL_MASK)];
+		Wheel[(lvl * WHEEL_SIZE) + ((now >> (WHEEL_BITS * lvl)) & WHEEL_MASK)] = NO_TMR;
+
+		for (; inx != NO_TMR; inx = next)
+		{
+			next = TmTbl[inx].next;
+			tmr_place (inx);
+		}
+	}
+
+	/*
+	 * everything left in the current level 0 slot is due now
+	 */
+
+	inx = Wheel[now & WHEEL_MASK];
+	Wheel[now & WHEEL_MASK] = NO_TMR;
+
+	for (; inx != NO_TMR; inx = next)
+	{
+		tm_p = &TmTbl[inx];
+		next = tm_p->next;
+
+		tm_p->slot = NO_TMR;
+
+		GXK_TRACE (TR_TIMER, tm_p->tid, tm_p->events, 0);
+
+		gxk_ev_post (tm_p->tid, tm_p->events);
+
+		if (tm_p->period != 0)
+		{
+			tm_p->expires += tm_p->period;
+			tmr_place (inx);
+		}
+		else
+		{
+			tmr_free (inx);
+		}
+	}
+
+	TmSliced = gxk_t_tick ();
+}
+
+#if TICK_THREAD
+
+/******************************************************************************
+*						  
+* Name:				tick_thread
+*
+* Type:				Function
+*
+* Description:		clock source driving the wheel off the host clock
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+static unsigned HOST_CALL tick_thread(void *arg)
+
+{
+	LONGLONG now;
+	DWORD wait;
+	UINT flush;
+
+	(void)arg;
+
+	/*
+	 * ticks are whatever the counter says has elapsed, so a late
+	 * wakeup is caught up rather than stretching the tick.  while
+	 * nothing is armed the thread sleeps until tmr_start signals, or
+	 * keeps ticking only to charge time-sliced tasks their quanta and
+	 * to send the frames of remote calls batched since the last tick
+	 */
+
+	for (;;)
+	{
+		gxk_k_lock ();
+
+		now = clock_now ();
+
+		if ((flush = (TmBatch && ((LONG)((ULONG)now - TickCount) > 0))) != FALSE)
+		{
+			TmBatch = FALSE;
+		}
+
+		if (TmArmed == 0)
+		{
+			/*
+			 * nothing to cascade; a late wakeup charges one tick
+			 */
+
+			if (((LONG)((ULONG)now - TickCount) > 0) && (TmSliced))
+			{
+				TmSliced = gxk_t_tick ();
+			}
+
+			TickCount = (ULONG)now;
+		}
+
+		while ((LONG)((ULONG)now - TickCount) > 0)
+		{
+			tmr_advance ();
+		}
+
+		wait = ((TmArmed == 0) && (TmSliced == FALSE) && (TmBatch == FALSE)) ? INFINITE : clock_due (now + 1);
+
+		gxk_k_unlock ();
+
+		if (flush)
+		{
+			gxk_nd_flush ();
+		}
+
+		gxk_h_evwait (ClockEvent, wait);
+	}
+
+	return (0);
+}
+
+#endif
+
+/******************************************************************************
+*						  
+* Name:				tm_cancel
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+		  
+ULONG tm_cancel(ULONG tmid)
+
+{
+	ULONG rtn;
+	UINT inx;
+	TMDESC *tm_p;
+
+	rtn = 0;
+	inx = (UINT)(tmid & 0xFFFF);
+
+	gxk_k_lock ();
+
+	if ((inx >= MAX_TIMER) || (TmTbl[inx].gen != (tmid >> 16)))
+	{
+		rtn = ERR_BADTMID;
+	}
+	else if (TmTbl[inx].used == FALSE)
+	{
+		/* one shot that already fired, or cancelled before */
+		rtn = ERR_TMNOTSET;
+	}
+	else
+	{
+		tm_p = &TmTbl[inx];
+
+		if (tm_p->slot != NO_TMR)
+		{
+			tmr_unlink (inx);
+		}
+
+		tmr_free (inx);
+	}
+
+	gxk_k_leave ();
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				tm_evafter
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG tm_evafter(ULONG ticks, ULONG events, ULONG *tmid)
+
+{
+	ULONG rtn;
+
+	if (ticks == 0)
+	{
+		rtn = ERR_ILLTICKS;
+	}
+	else
+	{
+		gxk_k_lock ();
+		rtn = tmr_start (ticks, 0, events, tmid);
+		gxk_k_leave ();
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				tm_evevery
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG tm_evevery(ULONG ticks, ULONG events, ULONG *tmid)
+
+{
+	ULONG rtn;
+
+	if (ticks == 0)
+	{
+		rtn = ERR_ILLTICKS;
+	}
+	else
+	{
+		gxk_k_lock ();
+		rtn = tmr_start (ticks, ticks, events, tmid);
+		gxk_k_leave ();
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				tm_evwhen
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG tm_evwhen(ULONG date, ULONG time, ULONG ticks, ULONG events, ULONG *tmid)
+
+{
+	ULONG rtn;
+	LONGLONG tick;
+
+	gxk_k_lock ();
+
+	if ((rtn = tod_target (date, time, ticks, &tick)) == 0)
+	{
+		rtn = tmr_start ((ULONG)(tick - clock_now ()), 0, events, tmid);
+	}
+
+	gxk_k_leave ();
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				tm_get
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG tm_get(ULONG *date, ULONG *time, ULONG *ticks)
+
+{
+	ULONG rtn;
+	
+	rtn = 0;
+
+	gxk_k_lock ();
+
+	if (TodSet == FALSE)
+	{
+		rtn = ERR_NOTIME;
+	}
+	else
+	{
+		cal_date (TodBase + clock_now (), date, time, ticks);
+	}
+
+	gxk_k_leave ();
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				tm_set
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG tm_set(ULONG date, ULONG time, ULONG ticks)
+
+{
+	ULONG rtn;
+	LONGLONG tod;
+
+	if ((rtn = cal_ticks (date, time, ticks, &tod)) == 0)
+	{
+		gxk_k_lock ();
+
+		TodBase = tod - clock_now ();
+		TodSet = TRUE;
+
+		gxk_k_leave ();
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				tm_tick
+*
+* Type:				Function
+*
+* Description:		announce a clock tick: advance the wheel and fire due timers
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG tm_tick(void)
+
+{
+	gxk_k_lock ();
+
+	tmr_advance ();
+
+	/*
+	 * a woken task that outranks the running one takes the CPU here
+	 */
+
+	gxk_k_unlock ();
+
+	/* remote calls batched since the last tick go out */
+	gxk_nd_flush ();
+
+	return (0);
+}
+
+/******************************************************************************
+*						  
+* Name:				tm_wkafter
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG tm_wkafter(ULONG ticks)
+
+{
+	LONGLONG tick;
+	DWORD msec;
+
+	if (ticks == 0)
+	{
+		/*
+		 * yield to ready tasks of the same priority
+		 */
+
+		gxk_t_delay (0);
+	}
+	else
+	{
+		/*
+		 * sleep to the tick boundary on the clock itself rather than
+		 * counting ticks off the wheel; a wait that comes back early
+		 * goes round again
+		 */
+
+		tick = clock_now () + ticks;
+
+		while ((msec = clock_due (tick)) != 0)
+		{
+			gxk_t_delay (msec);
+		}
+	}
+
+	return (0);
+}
+
+/******************************************************************************
+*						  
+* Name:				tm_wkperiod
+*
+* Type:				Function
+*
+* Description:		wait for the release of the calling periodic task's next job
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG tm_wkperiod(void)
+
+{
+	ULONG rtn;
+	ULONG release;
+	LONGLONG tick;
+	DWORD msec;
+	UINT self;
+
+	/*
+	 * a job that overran its period finds its next release passed
+	 * and carries straight on
+	 */
+
+	self = gxk_t_self ();
+
+	if (self >= MAX_TASK)
+	{
+		rtn = ERR_NOPERIOD;
+	}
+	else
+	{
+		gxk_k_lock ();
+		rtn = gxk_t_release (self, &release);
+		gxk_k_unlock ();
+	}
+
+	if (rtn == 0)
+	{
+		tick = clock_now ();
+		tick += (LONG)(release - (ULONG)tick);
+
+		while ((msec = clock_due (tick)) != 0)
+		{
+			gxk_t_delay (msec);
+		}
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				tm_wkwhen
+*
+* Type:				Function
+*
+* Description:		
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG tm_wkwhen(ULONG date, ULONG time, ULONG ticks)
+
+{
+	ULONG rtn;
+	LONGLONG tick;
+	DWORD msec;
+	
+	gxk_k_lock ();
+	rtn = tod_target (date, time, ticks, &tick);
+	gxk_k_leave ();
+
+	if (rtn == 0)
+	{
+		while ((msec = clock_due (tick)) != 0)
+		{
+			gxk_t_delay (msec);
+		}
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_tm_batch
+*
+* Type:				Function
+*
+* Description:		keep the clock ticking until the next tick sends batched frames
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_tm_batch(void)
+
+{
+	/*
+	 * called with the kernel locked when a remote call starts a frame
+	 * or a global object is deleted.  an idle tick_thread is woken
+	 * with the count caught up, so the frame goes at the end of the
+	 * current tick, not at once
+	 */
+
+	if (TmBatch == FALSE)
+	{
+		clock_sync ();
+
+		TmBatch = TRUE;
+
+#if TICK_THREAD
+		if ((TmArmed == 0) && (TmSliced == FALSE))
+		{
+			gxk_h_evset (ClockEvent);
+		}
+#endif
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_tm_init
+*
+* Type:				Function
+*
+* Description:		clear the timer table and start the clock
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_tm_init(void)
+
+{
+	UINT inx;
+#if TICK_THREAD
+	unsigned threadid;
+	GXKTHREAD thread;
+#endif
+
+	ClockFreq = gxk_h_freq ();
+	ClockBase = gxk_h_clock ();
+
+	TodBase = 0;
+	TodSet = FALSE;
+
+	TickCount = 0;
+	TmFree = NO_TMR;
+
+	for (inx = 0; inx < (WHEEL_LEVELS * WHEEL_SIZE); inx++)
+	{
+		Wheel[inx] = NO_TMR;
+	}
+
+	for (inx = MAX_TIMER; inx-- > 0; )
+	{
+		TmTbl[inx].gen = 0;
+		TmTbl[inx].slot = NO_TMR;
+		TmTbl[inx].used = FALSE;
+		tmr_free (inx);
+	}
+
+	TmArmed = 0;
+	TmSliced = FALSE;
+	TmBatch = FALSE;
+
+#if TICK_THREAD
+	ClockEvent = gxk_h_evcreate ();
+
+	if ((thread = gxk_h_thread (tick_thread, NULL, 0, &threadid)) != NULL)
+	{
+		/*
+		 * the clock outranks every task on a host that honours it
+		 */
+
+		gxk_h_setprio (thread, MAX_PRIO);
+		gxk_h_close (thread);
+	}
+#endif
+
+	return (0);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_tm_purge
+*
+* Type:				Function
+*
+* Description:		cancel every timer armed by a task
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_tm_purge(ULONG tid)
+
+{
+	UINT inx;
+
+	/*
+	 * called with the kernel locked from task deletion and restart
+	 */
+
+	for (inx = 0; inx < MAX_TIMER; inx++)
+	{
+		if ((TmTbl[inx].used) && (TmTbl[inx].tid == tid))
+		{
+			if (TmTbl[inx].slot != NO_TMR)
+			{
+				tmr_unlink (inx);
+			}
+
+			tmr_free (inx);
+		}
+	}
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_tm_msec
+*
+* Type:				Function
+*
+* Description:		convert a pSOS timeout in ticks to a win32 wait
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_tm_msec(ULONG ticks)
+
+{
+	ULONG rtn;
+
+	/*
+	 * a timeout of 0 waits forever; anything too long for a win32
+	 * wait is held just short of INFINITE
+	 */
+
+	if (ticks == 0)
+	{
+		rtn = INFINITE;
+	}
+	else if (ticks >= ((INFINITE - 1) / TICK_MSEC))
+	{
+		rtn = INFINITE - 1;
+	}
+	else
+	{
+		rtn = ticks * TICK_MSEC;
+	}
+
+	return (rtn);
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_tm_now
+*
+* Type:				Function
+*
+* Description:		the kernel clock, in ticks
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+ULONG gxk_tm_now(void)
+
+{
+	return ((ULONG)clock_now ());
+}
+
+/******************************************************************************
+*						  
+* Name:				gxk_tm_slice
+*
+* Type:				Function
+*
+* Description:		keep the clock ticking for a time-sliced task
+* 
+* Formal Inputs:	
+*
+* Global Inputs:	
+*
+* Formal Outputs:	
+*
+* Return Value:		
+*
+* Side Effects:		
+* 
+* Author:			GVH
+*
+******************************************************************************/
+
+void gxk_tm_slice(void)
+
+{
+	/*
+	 * called with the kernel locked when a T_TSLICE task is
+	 * dispatched.  an idle tick_thread is woken with the count caught
+	 * up, so the quantum starts from now
+	 */
+
+	if (TmSliced == FALSE)
+	{
+		clock_sync ();
+
+		TmSliced = TRUE;
+
+#if TICK_THREAD
+		if (TmArmed == 0)
+		{
+			gxk_h_evset (ClockEvent);
+		}
+#endif
+	}
 }
@@ -17,6 +17,8 @@ extern "C" {
 /*---------------------------------------------------------------------*/
 /* Don't allow this file to be included more than once.                */
 /*---------------------------------------------------------------------*/
+#ifndef _GXKERNEL_H
+#define _GXKERNEL_H
 
 #include "types.h"
 
@@ -43,6 +45,109 @@ struct ioparms
     ULONG out_retval;       /* For return value */
     };
 
+/*---------------------------------------------------------------------*/
+/* I/O Switch Table Entry (one per major device, see de_install)       */
+/*---------------------------------------------------------------------*/
+struct iojtab
+    {
+    void (*dev_init)(struct ioparms *);
+    void (*dev_open)(struct ioparms *);
+    void (*dev_close)(struct ioparms *);
+    void (*dev_read)(struct ioparms *);
+    void (*dev_write)(struct ioparms *);
+    void (*dev_cntrl)(struct ioparms *);
+    void (*dev_start)(struct ioparms *); /* de_submit queued requests; */
+                            /* NULL if the driver polls de_fetch */
+    ULONG flags;            /* IO_AUTOINIT */
+    };
+
+/*---------------------------------------------------------------------*/
+/* Asynchronous I/O Request (see de_submit)                            */
+/*---------------------------------------------------------------------*/
+struct iorequest
+    {
+    ULONG func;             /* IO_READ, IO_WRITE or IO_CNTRL */
+    ULONG dev;              /* Device number, set by de_submit */
+    void *iopb;             /* Driver's IO parameter block */
+    ULONG qid;              /* Queue posted on completion, or IO_NOQUEUE */
+    ULONG tid;              /* Task sent events on completion */
+    ULONG events;           /* Events sent, 0 for none */
+    ULONG err;              /* Set by de_done */
+    ULONG retval;           /* Set by de_done */
+    };
+
+/*---------------------------------------------------------------------*/
+/* Kernel Trace Record (see k_trace)                                   */
+/*---------------------------------------------------------------------*/
+struct trevent
+    {
+    ULONG stamp_hi;         /* Host clock (gxk_h_clock) when recorded */
+    ULONG stamp_lo;
+    ULONG core;             /* Trace ring it was recorded in */
+    ULONG event;            /* TR_* code */
+    ULONG id;               /* Task or object the event is about */
+    ULONG arg[2];           /* Event specific, see TR_* */
+    };
+
+/*---------------------------------------------------------------------*/
+/* Object Statistics (see q_info, sm_info and t_info)                  */
+/*---------------------------------------------------------------------*/
+struct qinfo
+    {
+    ULONG count;            /* Messages waiting */
+    ULONG peak;             /* Most messages ever waiting */
+    ULONG sent;             /* Messages sent, urgent and broadcast too */
+    ULONG received;         /* Messages received */
+    ULONG drops;            /* Messages refused with ERR_QFULL */
+    ULONG waiting;          /* Tasks blocked in q_receive */
+    };
+
+#define SM_WAITBINS     8   /* sminfo wait time bins */
+
+struct sminfo
+    {
+    ULONG count;            /* Units banked */
+    ULONG contended;        /* sm_p calls that found no unit */
+    ULONG blocked;          /* ... of which waited for one */
+    ULONG timeouts;         /* ... of which timed out */
+    ULONG waiting;          /* Tasks blocked in sm_p */
+    ULONG wait_hist[SM_WAITBINS]; /* Waits under 1 tick, 1, 2-3, */
+                            /* 4-7 ... ticks, the last bin longer */
+    };
+
+struct tinfo
+    {
+    ULONG prio;             /* Current priority, inherited included */
+    ULONG runtime;          /* Milliseconds spent dispatched */
+    ULONG switches;         /* Times dispatched */
+    };
+
+/*---------------------------------------------------------------------*/
+/* Multiple Object Wait Entry (see sl_wait)                            */
+/*---------------------------------------------------------------------*/
+struct slentry
+    {
+    ULONG type;             /* SL_QUEUE, SL_SEM or SL_EVENT */
+    ULONG id;               /* qid, smid, or the caller's events */
+                            /* wanted, any of them */
+    ULONG msg[4];           /* SL_QUEUE message received, SL_EVENT */
+                            /* events received in msg[0] */
+    };
+
+/*---------------------------------------------------------------------*/
+/* Multi-processor Configuration (see k_join)                          */
+/*---------------------------------------------------------------------*/
+struct mpcfg
+    {
+    ULONG node;             /* This node, 1 to nnodes */
+    ULONG nnodes;           /* Nodes in the system */
+    ULONG flags;            /* KIROSTER */
+    ULONG (*ki_send)(ULONG node, void *frame, ULONG len);
+                            /* Transmit a frame to a node */
+    void (*ki_roster)(ULONG node, ULONG change);
+                            /* RSTR_* call-out, if KIROSTER */
+    };
+
 /***********************************************************************/
 /* errno macro                                                         */
 /***********************************************************************/
@@ -59,10 +164,19 @@ ULONG as_return(void);
 ULONG ev_receive(ULONG events, ULONG flags, ULONG timeout, ULONG *events_r);
 ULONG ev_send(ULONG tid, ULONG events);
 
+void  i_return(void);
 void  k_fatal(ULONG err_code, ULONG flags);
+ULONG k_join(struct mpcfg *cfg);
+ULONG k_receive(void *frame, ULONG len);
 ULONG k_terminate(ULONG node, ULONG fcode, ULONG flags);
+ULONG k_trace(struct trevent *buf, ULONG max, ULONG *count);
 ULONG m_ext2int(void *ext_addr, void **int_addr);
 ULONG m_int2ext(void *int_addr, void **ext_addr);
+ULONG mu_create(char name[4], ULONG flags, ULONG ceiling, ULONG *muid);
+ULONG mu_delete(ULONG muid);
+ULONG mu_ident(char name[4], ULONG node, ULONG *muid);
+ULONG mu_lock(ULONG muid, ULONG flags, ULONG timeout);
+ULONG mu_unlock(ULONG muid);
 ULONG pt_create(char name[4], void *paddr, void *laddr, ULONG length,
                 ULONG bsize, ULONG flags, ULONG *ptid, ULONG *nbuf);
 ULONG pt_delete(ULONG ptid);
@@ -75,16 +189,25 @@ ULONG q_create(char name[4], ULONG count, ULONG flags, ULONG *qid);
 
 ULONG q_delete(ULONG qid);
 ULONG q_ident(char name[4], ULONG node, ULONG *qid);
+ULONG q_info(ULONG qid, struct qinfo *info);
 ULONG q_receive(ULONG qid, ULONG flags, ULONG timeout, ULONG msg_buf[4]);
+ULONG q_receive_n(ULONG qid, ULONG flags, ULONG timeout, ULONG msg_buf[][4],
+                  ULONG n, ULONG *count);
 ULONG q_send(ULONG qid, ULONG msg_buf[4]);
+ULONG q_send_n(ULONG qid, ULONG msg_buf[][4], ULONG n, ULONG *count);
 ULONG q_urgent(ULONG qid, ULONG msg_buf[4]);
 
+ULONG q_vborrow(ULONG qid, ULONG flags, ULONG timeout, void **msgbuf,
+                ULONG *msg_len);
+ULONG q_vcommit(ULONG qid, void *msgbuf, ULONG msg_len);
 ULONG q_vcreate(char name[4], ULONG flags, ULONG maxnum, ULONG maxlen,
                 ULONG *qid);
 ULONG q_vdelete(ULONG qid);
 ULONG q_vident(char name[4], ULONG node, ULONG *qid);
 ULONG q_vreceive(ULONG qid, ULONG flags, ULONG timeout, void *msgbuf,
                  ULONG buf_len, ULONG *msg_len);
+ULONG q_vrelease(ULONG qid, void *msgbuf);
+ULONG q_vreserve(ULONG qid, void **msgbuf);
 ULONG q_vsend(ULONG qid, void *msgbuf, ULONG msg_len);
 ULONG q_vurgent(ULONG qid, void *msgbuf, ULONG msg_len);
 ULONG q_vbroadcast(ULONG qid, void *msgbuf, ULONG msg_len, ULONG *count);
@@ -97,9 +220,13 @@ ULONG rn_getseg(ULONG rnid, ULONG size, ULONG flags, ULONG timeout,
 ULONG rn_ident(char name[4], ULONG *rnid);
 ULONG rn_retseg(ULONG rnid, void *seg_addr);
 
+ULONG sl_wait(struct slentry set[], ULONG n, ULONG flags, ULONG timeout,
+              ULONG *ready);
+
 ULONG sm_create(char name[4], ULONG count, ULONG flags,ULONG *smid);
 ULONG sm_delete(ULONG smid);
 ULONG sm_ident(char name[4], ULONG node, ULONG *smid);
+ULONG sm_info(ULONG smid, struct sminfo *info);
 ULONG sm_p(ULONG smid, ULONG flags, ULONG timeout);
 ULONG sm_v(ULONG smid);
 
@@ -108,10 +235,13 @@ ULONG t_create(char name[4], ULONG prio, ULONG sstack, ULONG ustack,
 ULONG t_delete(ULONG tid);
 ULONG t_getreg(ULONG tid, ULONG regnum, ULONG *reg_value);
 ULONG t_ident(char name[4], ULONG node, ULONG *tid);
+ULONG t_info(ULONG tid, struct tinfo *info);
 ULONG t_mode(ULONG mask, ULONG new_mode, ULONG *old_mode);
 
 ULONG t_restart(ULONG tid, ULONG targs[]);
 ULONG t_resume(ULONG tid);
+ULONG t_setaffinity(ULONG tid, ULONG mask, ULONG *old_mask);
+ULONG t_setperiod(ULONG tid, ULONG period, ULONG deadline, ULONG cost);
 ULONG t_setpri(ULONG tid, ULONG newprio, ULONG *oldprio);
 ULONG t_setreg(ULONG tid, ULONG regnum, ULONG reg_value);
 ULONG t_start(ULONG tid, ULONG mode, void (*start_addr)(), ULONG targs[]);
@@ -128,6 +258,7 @@ ULONG tm_get(ULONG *date, ULONG *time, ULONG *ticks);
 ULONG tm_set(ULONG date, ULONG time, ULONG ticks);
 ULONG tm_tick(void);
 ULONG tm_wkafter(ULONG ticks);
+ULONG tm_wkperiod(void);
 ULONG tm_wkwhen(ULONG date, ULONG time, ULONG ticks);
 
 /*---------------------------------------------------------------------*/
@@ -164,6 +295,11 @@ ULONG de_open(ULONG dev, void *iopb, void *retval);
 ULONG de_read(ULONG dev, void *iopb, void *retval);
 ULONG de_write(ULONG dev, void *iopb, void *retval);
 
+ULONG de_done(struct iorequest *req, ULONG err, ULONG retval);
+ULONG de_fetch(ULONG dev, struct iorequest **req);
+ULONG de_install(ULONG major, struct iojtab *entry);
+ULONG de_submit(ULONG dev, struct iorequest *req);
+
 /***********************************************************************/
 /* Symbol Definitions                                                  */
 /***********************************************************************/
@@ -204,6 +340,20 @@ ULONG de_write(ULONG dev, void *iopb, void *retval);
 #define T_LEVELMASK6    0x00000100   /* For compatibility with 68K */    
 #define T_LEVELMASK7    0x00000100   /* For compatibility with 68K */    
 
+/*---------------------------------------------------------------------*/
+/* de_install(), de_submit() and de_done() Definitions                 */
+/*---------------------------------------------------------------------*/
+#define DE_DEV(maj,min) (((ULONG)(maj) << 16) | (min)) /* Device number */
+#define DE_MAJOR(dev)   ((dev) >> 16)
+#define DE_MINOR(dev)   ((dev) & 0xFFFF)
+#define IO_INIT         0           /* iorequest func codes */
+#define IO_OPEN         1
+#define IO_CLOSE        2
+#define IO_READ         3
+#define IO_WRITE        4
+#define IO_CNTRL        5
+#define IO_NOQUEUE      0xFFFFFFFF  /* No completion message */
+
 /*---------------------------------------------------------------------*/
 /* ev_receive() Definitions                                            */
 /*---------------------------------------------------------------------*/
@@ -218,6 +368,22 @@ ULONG de_write(ULONG dev, void *iopb, void *retval);
 #define K_GLOBAL        0x00000001  /* 1 = Global */
 #define K_LOCAL         0x00000000  /* 0 = Local */
 
+/*---------------------------------------------------------------------*/
+/* k_trace() Definitions                                               */
+/*---------------------------------------------------------------------*/
+#define TR_LOST         0           /* arg[0] records dropped, ring full */
+#define TR_SWITCH       1           /* id core, arg[0] task out, arg[1] in */
+#define TR_BLOCK        2           /* id task, arg[0] timeout in msec */
+#define TR_WAKE         3           /* id task, arg[0] wait completion */
+#define TR_SMBLOCK      4           /* id smid, arg[0] task blocking */
+#define TR_SMWAKE       5           /* id smid, arg[0] task given the unit */
+#define TR_QSEND        6           /* id qid, arg[0] error, arg[1] count */
+#define TR_QRECV        7           /* id qid, arg[0] error, arg[1] count */
+#define TR_EVSEND       8           /* id task, arg[0] events */
+#define TR_TIMER        9           /* id task, arg[0] events */
+#define TR_FATAL        10          /* id err_code, arg[0] flags */
+#define TR_NONE         0xFFFFFFFF  /* No task, in TR_SWITCH */
+
 /*---------------------------------------------------------------------*/
 /* mm_l2p(), mm_pmap(), and mm_sprotect() Definitions                  */
 /*---------------------------------------------------------------------*/
@@ -228,6 +394,25 @@ ULONG de_write(ULONG dev, void *iopb, void *retval);
 #define MM_NOACCESS     0x00000400  /* Deny access */
 #define MM_ACCESS       0x00000000  /* Permit access */
 
+/*---------------------------------------------------------------------*/
+/* mu_create() Definitions                                             */
+/*---------------------------------------------------------------------*/
+#define MU_GLOBAL       0x00000001  /* 1 = Global */
+#define MU_LOCAL        0x00000000  /* 0 = Local */
+#define MU_PRIOR        0x00000002  /* Queue by priority */
+#define MU_FIFO         0x00000000  /* Queue by FIFO order */
+#define MU_RECURSIVE    0x00000004  /* Owner may lock again */
+#define MU_NORECURSIVE  0x00000000  /* Owner may not lock again */
+#define MU_PRIO_NONE    0x00000000  /* Owner keeps its priority */
+#define MU_PRIO_INHERIT 0x00000010  /* Owner inherits waiters' priority */
+#define MU_PRIO_PROTECT 0x00000020  /* Owner runs at the ceiling */
+
+/*---------------------------------------------------------------------*/
+/* mu_lock() Definitions                                               */
+/*---------------------------------------------------------------------*/
+#define MU_NOWAIT       0x00000001  /* Don't wait for the mutex */
+#define MU_WAIT         0x00000000  /* Wait for the mutex */
+
 /*---------------------------------------------------------------------*/
 /* pt_create() Definitions                                             */
 /*---------------------------------------------------------------------*/
@@ -235,6 +420,7 @@ ULONG de_write(ULONG dev, void *iopb, void *retval);
 #define PT_LOCAL        0x00000000  /* 0 = Local */
 #define PT_DEL          0x00000004  /* 1 = Delete regardless */
 #define PT_NODEL        0x00000000  /* 0 = Delete only if unused */
+#define PT_MAG          0x00000010  /* 1 = Per-task buffer caches */
 
 /*---------------------------------------------------------------------*/
 /* q_create() and q_vcreate() Definitions                              */
@@ -268,6 +454,15 @@ ULONG de_write(ULONG dev, void *iopb, void *retval);
 #define RN_NOWAIT       0x00000001  /* Don't wait for memory */
 #define RN_WAIT         0x00000000  /* Wait for a segment */
 
+/*---------------------------------------------------------------------*/
+/* sl_wait() Definitions                                               */
+/*---------------------------------------------------------------------*/
+#define SL_QUEUE        1           /* slentry types */
+#define SL_SEM          2
+#define SL_EVENT        3
+#define SL_NOWAIT       0x00000001  /* Don't wait for any entry */
+#define SL_WAIT         0x00000000  /* Wait for the first ready entry */
+
 /*---------------------------------------------------------------------*/
 /* sm_create() Definitions                                             */
 /*---------------------------------------------------------------------*/
@@ -289,6 +484,10 @@ ULONG de_write(ULONG dev, void *iopb, void *retval);
 #define T_LOCAL         0x00000000   /* 0 = Local */
 #define T_NOFPU         0x00000000   /* Not using FPU */
 #define T_FPU           0x00000002   /* Using FPU bit */
+#define T_ANYCORE       0x00000000   /* Run on any core */
+#define T_CORES(m)      (((ULONG)(m) & 0xFFFF) << 16)  /* Run only on */
+                                                /* cores in mask m */
+#define T_CORESOF(f)    (((ULONG)(f) >> 16) & 0xFFFF)   /* Cores of flags */
 
 /***********************************************************************/
 /* Error Codes                                                         */
@@ -314,6 +513,10 @@ ULONG de_write(ULONG dev, void *iopb, void *retval);
 /*---------------------------------------------------------------------*/
 /* Task Service Group Errors                                           */
 /*---------------------------------------------------------------------*/
+#define ERR_NOPERIOD 0x0A     /* Task is not periodic */
+#define ERR_OVERLOAD 0x0B     /* Periodic tasks would not be */
+                              /* schedulable */
+#define ERR_NOCORE   0x0C     /* Affinity names no configured core */
 #define ERR_RSTFS    0x0D     /* Informative; files may be corrupted */
                               /* on restart */
 #define ERR_NOTCB    0x0E     /* Exceeds node's maximum number of tasks */
@@ -395,6 +598,8 @@ ULONG de_write(ULONG dev, void *iopb, void *retval);
                               /* pending in the queue */
 #define ERR_VARQ     0x3A     /* Queue is variable size */
 #define ERR_NOTVARQ  0x3B     /* Queue is not variable size */
+#define ERR_MAXMSG   0x7A     /* Cannot create; no messages, or too many */
+                              /* or too long to address */
 
 /*---------------------------------------------------------------------*/
 /* Event/Asynch Signal Service Group Errors                            */
@@ -402,6 +607,8 @@ ULONG de_write(ULONG dev, void *iopb, void *retval);
 #define ERR_NOEVS    0x3C     /* Selected events not pending; this error */
                               /* code is returned only if the EV_NOWAIT */
                               /* attribute was selected */
+#define ERR_ASFULL   0x3D     /* Deferred work full; asynchronous call */
+                              /* not made */
 #define ERR_NOTINASR 0x3E     /* Illegal, not called from an ASR */
 #define ERR_NOASR    0x3F     /* Task has no valid ASR */
 
@@ -442,12 +649,39 @@ ULONG de_write(ULONG dev, void *iopb, void *retval);
 #define ERR_NDKLD    0x66     /* Remote Node no longer in service */
 #define ERR_MASTER   0x67     /* Cannot terminate Master node */
 
+/*---------------------------------------------------------------------*/
+/* Mutex Service Group Errors                                          */
+/*---------------------------------------------------------------------*/
+#define ERR_NOMUCB   0x70     /* Exceeds node's maximum number of */
+                              /* mutexes */
+#define ERR_NOMUTEX  0x71     /* Mutex locked; this error code is */
+                              /* returned only if MU_NOWAIT was selected */
+#define ERR_MUKILLD  0x72     /* Mutex deleted while task waiting */
+#define ERR_TATMUDEL 0x73     /* Informative only; there were tasks */
+                              /* waiting */
+#define ERR_NOTOWNER 0x74     /* Caller does not own the mutex */
+#define ERR_MURECURSE 0x75    /* Mutex already held by the caller and */
+                              /* not MU_RECURSIVE */
+#define ERR_MULOCKED 0x76     /* Cannot delete; locked by another task */
+#define ERR_CEILING  0x77     /* Caller's priority is above the mutex */
+                              /* ceiling */
+
+/*---------------------------------------------------------------------*/
+/* Multiple Object Wait Errors                                         */
+/*---------------------------------------------------------------------*/
+#define ERR_NOSEL    0x78     /* No entry ready; this error code is */
+                              /* returned only if SL_NOWAIT was selected */
+#define ERR_SELSIZE  0x79     /* Set is empty or exceeds MAX_SELECT */
+                              /* entries */
+
 /*---------------------------------------------------------------------*/
 /* IO Service Group Errors                                             */
 /*---------------------------------------------------------------------*/
 #define ERR_IODN     0x101    /* Illegal device (major) number */
 #define ERR_NODR     0x102    /* No driver provided */
 #define ERR_IOOP     0x103    /* Illegal I/O function number */
+#define ERR_IOFULL   0x104    /* Device's request ring is full */
+#define ERR_NOIOREQ  0x105    /* No request queued; returned by de_fetch */
 
 /*---------------------------------------------------------------------*/
 /* Fatal Errors During Startup                                         */